@@ -0,0 +1,112 @@
+//Copyright 2017 Laurent Monasse
+
+/*
+  This file is part of CELIA3D.
+  
+  CELIA3D is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  CELIA3D is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  
+  You should have received a copy of the GNU General Public License
+  along with CELIA3D.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+   \file
+   \authors Laurent Monasse and Maria Adela Puscas
+   \brief Recording of the anomalies detected during the simulation.
+ */
+
+#include <iostream>
+#include <fstream>
+#include "parametres.hpp"
+
+#ifndef ANOMALIES_HPP
+#define ANOMALIES_HPP
+
+//! \brief Types of anomalies
+enum Type_anomalie {anomalie_vitesse_son_x,   //!<Negative squared speed of sound in the x-flux
+		    anomalie_vitesse_son_y,   //!<Negative squared speed of sound in the y-flux
+		    anomalie_vitesse_son_z,   //!<Negative squared speed of sound in the z-flux
+		    anomalie_pression_densite,//!<Negative pressure or density in the boundary conditions
+		    anomalie_lecture_reprise, //!<Read error in the restart file
+		    nb_types_anomalie
+};
+
+/*!\brief Anomalies detected during the simulation.
+
+Each anomaly is counted and recorded with the state of the cells involved in the file resultats/anomalies.dat (one line per anomaly), without stopping the computation. With the policy \a anomalie_arret, a stop is requested: the main loop writes the state and the binary checkpoint at the end of the time-step and exits.
+*/
+class Anomalies
+{
+public:
+  Anomalies(): arret(false) {
+    for(int l=0;l<nb_types_anomalie;l++){
+      compteurs[l] = 0;
+    }
+  }
+  
+  /*!\brief Records an anomaly of type \a type at time \a t.
+    \return stream of the anomaly file, where the state of the cells involved is written on the same line
+  */
+  std::ostream& Signale(const int type, const double t){
+    if(!fichier.is_open()){
+      fichier.open("resultats/anomalies.dat",std::ios::out);
+      if(!fichier){
+	std::cout << "Opening of 'anomalies.dat' failed" << std::endl;
+      }
+    }
+    compteurs[type]++;
+    if(politique_anomalie==anomalie_arret){
+      arret = true;
+    }
+    std::ostream& out = fichier.is_open() ? static_cast<std::ostream&>(fichier) : std::cout;
+    out << t << " " << nom(type) << " ";
+    return out;
+  }
+  
+  //! \brief Number of anomalies of type \a type
+  int nombre(const int type) const { return compteurs[type]; }
+  
+  //! \brief Total number of anomalies
+  int total() const {
+    int n = 0;
+    for(int l=0;l<nb_types_anomalie;l++){
+      n += compteurs[l];
+    }
+    return n;
+  }
+  
+  //! \brief True if a stop of the computation has been requested
+  bool arret_demande() const { return arret; }
+  
+  //! \brief Writes the number of anomalies of each type in \a out
+  void Affiche(std::ostream& out) const {
+    for(int l=0;l<nb_types_anomalie;l++){
+      if(compteurs[l]>0){
+	out << "Anomalies " << nom(l) << ": " << compteurs[l] << std::endl;
+      }
+    }
+  }
+  
+  //! \brief Name of the anomaly type \a type
+  static const char* nom(const int type) {
+    static const char* noms[nb_types_anomalie] = {"vitesse_son_x", "vitesse_son_y", "vitesse_son_z", "pression_densite", "lecture_reprise"};
+    return noms[type];
+  }
+  
+private:
+  int compteurs[nb_types_anomalie]; //!< Number of anomalies of each type
+  bool arret; //!< Stop requested
+  std::ofstream fichier; //!< Anomaly file
+};
+
+Anomalies anomalies; //!< Anomalies detected during the simulation
+
+#endif
@@ -0,0 +1,200 @@
+//Copyright 2017 Laurent Monasse
+
+/*
+  This file is part of CELIA3D.
+
+  CELIA3D is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  CELIA3D is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with CELIA3D.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+   \file
+   \authors Laurent Monasse and Maria Adela Puscas
+   \brief Frequent light outputs of the fluid: axis-aligned slices and subsampled volumes.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include "parametres.hpp"
+#include "sorties.hpp"
+#include "fluide.hpp"
+
+#ifndef COUPES_HPP
+#define COUPES_HPP
+
+/*!\brief Slices and subsampled volumes of the fluid, each one written with its own period.
+
+The outputs are read in file <b> "coupes.dat" </b> (no output if the file does not exist), one per line, lines starting with # being ignored:
+- \b "COUPE" axis index period [fields]: slice of the cells of index \a index (from 0, without the margins) in the direction \a axis (x, y or z), every \a period in time;
+- \b "VOLUME" stride period [fields]: one cell out of \a stride in each direction, every \a period in time.
+
+The fields are chosen among pressure, density, u, v, w and alpha (all of them if none is given). The outputs are scheduled at the times k*period from t=0, and each one is written in file coupe_<axis><index>_<n>.vtk or volume<stride>_<n>.vtk, where n is the index k of its scheduled time (so that a restarted computation goes on with the same numbering), as point data at the cell centers of a STRUCTURED_POINTS dataset (same frame as the files fluide*.vtk), in binary or in ASCII depending on \a sortie_binaire.
+*/
+class Coupes
+{
+public:
+  /*!\brief Reads the outputs in \a nom.
+    \param nom output file
+    \param t initial time (time of the checkpoint on a restart): the outputs scheduled before \a t are considered as written
+    \return void
+  */
+  void Init(const char* nom, const double t){
+    std::ifstream in(nom,std::ios::in);
+    if(!in){
+      return;
+    }
+    std::string ligne;
+    while(std::getline(in,ligne)){
+      std::istringstream mots(ligne);
+      std::string mot, champ;
+      if(!(mots >> mot) || mot[0]=='#'){
+	continue;
+      }
+      Coupe C;
+      bool valide = false;
+      if(mot=="COUPE"){
+	char axe;
+	valide = bool(mots >> axe >> C.indice >> C.periode);
+	C.axe = axe-'x';
+	const int N[3] = {Nx, Ny, Nz};
+	valide = valide && C.axe>=0 && C.axe<3 && C.indice>=0 && C.indice<N[C.axe];
+	std::ostringstream oss;
+	oss << "coupe_" << axe << C.indice;
+	C.nom = oss.str();
+      }
+      else if(mot=="VOLUME"){
+	C.axe = -1;
+	valide = bool(mots >> C.indice >> C.periode) && C.indice>0;
+	std::ostringstream oss;
+	oss << "volume" << C.indice;
+	C.nom = oss.str();
+      }
+      while(valide && mots >> champ){
+	int m = 0;
+	while(m<6 && champ!=noms[m]){
+	  m++;
+	}
+	if(m==6){
+	  std::cout << "Unknown field " << champ << " in " << nom << std::endl;
+	  continue;
+	}
+	C.champs.push_back(m);
+      }
+      if(!valide || C.periode<=0.){
+	std::cout << "Output '" << ligne << "' ignored in " << nom << std::endl;
+	continue;
+      }
+      if(C.champs.empty()){
+	for(int m=0; m<6; m++){
+	  C.champs.push_back(m);
+	}
+      }
+      C.numero = std::max(0,int(std::ceil(t/C.periode-1.e-9)));
+      C.prochaine = C.numero*C.periode;
+      coupes.push_back(C);
+    }
+  }
+
+  /*!\brief Writes the outputs whose time has come.
+    \details Called at the beginning of each time-step, as the full outputs of \a Ecriture_asynchrone.
+    \param Fluide fluid
+    \param t time
+    \return void
+  */
+  void Sorties(Grille& Fluide, const double t){
+    for(int c=0; c<coupes.size(); c++){
+      Coupe& C = coupes[c];
+      if(t>=C.prochaine){
+	Ecrit(Fluide,C);
+	while(C.prochaine<=t){
+	  C.numero++;
+	  C.prochaine = C.numero*C.periode;
+	}
+      }
+    }
+  }
+
+private:
+  //! \brief Slice or subsampled volume
+  struct Coupe
+  {
+    int axe;                 //!< Direction of the slice (0, 1 or 2), -1 for a subsampled volume
+    int indice;              //!< Index of the slice, or stride of the volume
+    double periode;          //!< Time between two outputs
+    double prochaine;        //!< Time of the next output
+    int numero;              //!< Index of the next scheduled time (\a prochaine = \a numero * \a periode), index of the next output file
+    std::vector<int> champs; //!< Fields written (indices in \a noms)
+    std::string nom;         //!< Prefix of the output files
+  };
+
+  //! \brief Writes the output \a C of the fluid in file resultats/<C.nom>_<C.numero>.vtk
+  void Ecrit(Grille& Fluide, const Coupe& C){
+    const int N[3] = {Nx, Ny, Nz};
+    const double d[3] = {Fluide.dx, Fluide.dy, Fluide.dz};
+    int debut[3], pas[3], dimensions[3];
+    for(int a=0; a<3; a++){
+      if(C.axe<0){
+	debut[a] = 0; pas[a] = C.indice;
+      } else {
+	debut[a] = (a==C.axe) ? C.indice : 0; pas[a] = 1;
+      }
+      const int fin = (a==C.axe) ? C.indice+1 : N[a];
+      dimensions[a] = (fin-debut[a]+pas[a]-1)/pas[a];
+    }
+    std::ostringstream oss;
+    oss << "resultats/" << C.nom << "_" << C.numero << ".vtk";
+    std::ofstream vtk(oss.str().c_str(),std::ios::out|std::ios::binary);
+    if(!vtk){
+      std::cout << "Opening of " << oss.str() << " failed" << std::endl;
+      return;
+    }
+    vtk << "# vtk DataFile Version 3.0" << "\n";
+    vtk << "#Simulation Euler" << "\n";
+    vtk << (sortie_binaire ? "BINARY" : "ASCII") << "\n";
+    vtk << "DATASET STRUCTURED_POINTS" << "\n";
+    vtk << "DIMENSIONS " << dimensions[0] << " " << dimensions[1] << " " << dimensions[2] << "\n";
+    vtk << std::setprecision(15);
+    vtk << "ORIGIN " << (debut[0]+0.5)*d[0] << " " << (debut[1]+0.5)*d[1] << " " << (debut[2]+0.5)*d[2] << "\n";
+    vtk << "SPACING " << pas[0]*d[0] << " " << pas[1]*d[1] << " " << pas[2]*d[2] << "\n";
+    vtk << std::setprecision(6);
+    vtk << "POINT_DATA " << dimensions[0]*dimensions[1]*dimensions[2] << "\n";
+    double Cellule::* const champs[6] = {&Cellule::p, &Cellule::rho, &Cellule::u, &Cellule::v, &Cellule::w, &Cellule::alpha};
+    std::vector<double> valeurs(dimensions[0]*dimensions[1]*dimensions[2]);
+    for(int m=0; m<C.champs.size(); m++){
+      int l = 0;
+      for(int k=0; k<dimensions[2]; k++){
+	for(int j=0; j<dimensions[1]; j++){
+	  for(int i=0; i<dimensions[0]; i++){
+	    valeurs[l++] = Fluide.grille[debut[0]+i*pas[0]+marge][debut[1]+j*pas[1]+marge][debut[2]+k*pas[2]+marge].*champs[C.champs[m]];
+	  }
+	}
+      }
+      vtk << "SCALARS " << noms[C.champs[m]] << " double 1" << "\n";
+      vtk << "LOOKUP_TABLE default" << "\n";
+      Ecrit_tableau_vtk(vtk,valeurs,dimensions[0],sortie_binaire);
+    }
+  }
+
+  std::vector<Coupe> coupes; //!< Outputs read in coupes.dat
+  static const char* const noms[6]; //!< Names of the fields
+};
+
+const char* const Coupes::noms[6] = {"pressure", "density", "u", "v", "w", "alpha"};
+
+#endif
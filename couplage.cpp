@@ -48,15 +48,15 @@
  */
 void Grille::Forces_fluide(Solide& S, const double dt){
 	
-  Vector_3 Ffluide(0.,0.,0.);
+  Vecteur_3 Ffluide(0.,0.,0.);
   //Update of fluid forces and torques on the solid
   for(int iter_s=0; iter_s<S.size(); iter_s++){ 
 		
     S.solide[iter_s].Ffprev = S.solide[iter_s].Ff;
     S.solide[iter_s].Mfprev = S.solide[iter_s].Mf;
-    Point_3 Xn = S.solide[iter_s].x0 + S.solide[iter_s].Dx;
+    Point_3 Xn = S.solide[iter_s].x0 + S.solide[iter_s].Dx.vector_3();
     double fx=0.; double fy=0.; double fz=0.;
-    Kernel::FT mx = 0.,my = 0. ,mz = 0.;
+    Vecteur_3 M(0.,0.,0.);
 		
     for(int it=0; it<S.solide[iter_s].triangles.size(); it++){
       for(int iter=0; iter<S.solide[iter_s].Position_Triangles_interface[it].size(); iter++)
@@ -70,21 +70,21 @@ void Grille::Forces_fluide(Solide& S, const double dt){
 	    double tempx = (grille[i][j][k].pdtx/dt) * aire * (CGAL::to_double(S.solide[iter_s].normales[it].x()));
 	    double tempy = (grille[i][j][k].pdty/dt) * aire * (CGAL::to_double(S.solide[iter_s].normales[it].y()));
 	    double tempz = (grille[i][j][k].pdtz/dt) * aire * (CGAL::to_double(S.solide[iter_s].normales[it].z()));
-	    Vector_3 temp_Mf = cross_product(Vector_3(Xn,Point_3(centroid(S.solide[iter_s].Triangles_interface[it][iter].operator[](0),
-									  S.solide[iter_s].Triangles_interface[it][iter].operator[](1),
-									  S.solide[iter_s].Triangles_interface[it][iter].operator[](2)))), 
-					     Vector_3(-tempx,-tempy,-tempz));
+	    Vecteur_3 temp_Mf = cross_product(Vecteur_3(Vector_3(Xn,Point_3(centroid(S.solide[iter_s].Triangles_interface[it][iter].operator[](0),
+										     S.solide[iter_s].Triangles_interface[it][iter].operator[](1),
+										     S.solide[iter_s].Triangles_interface[it][iter].operator[](2))))), 
+					      Vecteur_3(-tempx,-tempy,-tempz));
 	    fx-= tempx; fy-= tempy; fz-= tempz;
-	    mx+= temp_Mf.x(); my+= temp_Mf.y(); mz+= temp_Mf.z();
+	    M += temp_Mf;
 	  }
 	}
       }
     }
-    S.solide[iter_s].Ff = Vector_3(fx,fy,fz);
-    S.solide[iter_s].Mf = Vector_3(CGAL::to_double(mx),CGAL::to_double(my),CGAL::to_double(mz)); 
+    S.solide[iter_s].Ff = Vecteur_3(fx,fy,fz);
+    S.solide[iter_s].Mf = M;
     Ffluide = Ffluide + S.solide[iter_s].Ff;
   }
-  cout<<"Fluid forces "<<Ffluide<<endl;
+  JOURNAL(journal_couplage,journal_diagnostic)<<"Fluid forces "<<Ffluide<<"\n";
   for(int it=0; it<S.solide.size(); it++){
     for(int i=0; i<S.solide[it].faces.size(); i++){
       if(S.solide[it].faces[i].voisin == -2){
@@ -161,7 +161,7 @@ void Grille::Modif_fnum(const double dt){
       }
     }
   }
-  Vector_3 Phi(phi_x, phi_y, phi_z); cout<<" Boundary flux "<<Phi<<endl;
+  JOURNAL(journal_couplage,journal_diagnostic)<<" Boundary flux "<<Vector_3(phi_x, phi_y, phi_z)<<"\n";
 }
 
 /*!\brief Conservative mixing of small cut-cells.
@@ -1140,7 +1140,7 @@ void Grille::cells_intersection_face(int& in,int& jn,int& kn,int& in1,int& jn1,i
  \warning <b> Specific coupling procedure ! </b>
  \return void
  */
-void Grille::swap_face(const Triangles& T3d_prev, const Triangles& T3d_n, const double dt, Particule & P, double & volume_test){
+void Grille::swap_face(const Triangles& T3d_prev, const Triangles& T3d_n, const double dt, Particule & P, Swap_accumulateur& acc){
 	
   std::vector<Bbox> box_prismes(T3d_prev.size());
   for (int i=0; i< T3d_prev.size(); i++){
@@ -1186,20 +1186,21 @@ void Grille::swap_face(const Triangles& T3d_prev, const Triangles& T3d_n, const
       }
     } 
 		  
-    Cellule& c= grille[in1][jn1][kn1];
+    const Cellule& c= grille[in1][jn1][kn1];
+    Swap_contribution& w= acc.cellule(in1,jn1,kn1);
     double volume_cel = c.dx*c.dy*c.dz;  
     if ( (in==in1) && (jn==jn1) && (kn==kn1) && (interieur==true)){
       //The prism is contained in one single cell
       double volume_p=volume_prisme(T3d_prev[i],T3d_n[i]);
       //Computation of the volume
       if( (std::abs(volume_p)>eps) && (std::abs(1.-c.alpha)>eps)){
-	c.delta_w[0] += volume_p*c.rho0/volume_cel; 
-	c.delta_w[1] += volume_p*c.impx0/volume_cel;
-	c.delta_w[2] += volume_p*c.impy0/volume_cel; 
-	c.delta_w[3] += volume_p*c.impz0/volume_cel; 
-	c.delta_w[4] += volume_p*c.rhoE0/volume_cel;
+	w.delta_w[0] += volume_p*c.rho0/volume_cel; 
+	w.delta_w[1] += volume_p*c.impx0/volume_cel;
+	w.delta_w[2] += volume_p*c.impy0/volume_cel; 
+	w.delta_w[3] += volume_p*c.impz0/volume_cel; 
+	w.delta_w[4] += volume_p*c.rhoE0/volume_cel;
       }
-      volume_test += volume_p;
+      acc.volume_test += volume_p;
     }	
     else if((std::abs(volume_prisme(T3d_prev[i],T3d_n[i])) >eps)  && (interieur==true) && (std::abs(1.-c.alpha)>eps)) {
       std::vector<Bbox> box_cells;
@@ -1298,31 +1299,29 @@ void Grille::swap_face(const Triangles& T3d_prev, const Triangles& T3d_n, const
 	  } 			
 	}
 			
-	c.delta_w[0] += volume*Cells[iter].rho0/volume_cel; 
-	c.delta_w[1] += volume*Cells[iter].impx0/volume_cel;
-	c.delta_w[2] += volume*Cells[iter].impy0/volume_cel; 
-	c.delta_w[3] += volume*Cells[iter].impz0/volume_cel; 
-	c.delta_w[4] += volume*Cells[iter].rhoE0/volume_cel;
-	grille[in1][jn1][kn1] = c;
+	w.delta_w[0] += volume*Cells[iter].rho0/volume_cel; 
+	w.delta_w[1] += volume*Cells[iter].impx0/volume_cel;
+	w.delta_w[2] += volume*Cells[iter].impy0/volume_cel; 
+	w.delta_w[3] += volume*Cells[iter].impz0/volume_cel; 
+	w.delta_w[4] += volume*Cells[iter].rhoE0/volume_cel;
 				
-	volume_test += volume;
+	acc.volume_test += volume;
       } 
     }
     if (explicite){
       Vector_3 norm_prev= orthogonal_vector(T3d_prev[i].operator[](0),T3d_prev[i].operator[](1),T3d_prev[i].operator[](2));
       double norm2_prev= sqrt(CGAL::to_double(norm_prev*norm_prev));
       if(norm2_prev>eps){ 
-	Cellule c_prev= grille[in][jn][kn];
+	const Cellule& c_prev= grille[in][jn][kn];
 	Vector_3 n_prev = norm_prev/norm2_prev;
 	double aire_prev = sqrt(CGAL::to_double(T3d_prev[i].squared_area()));
-	c.phi_x += c_prev.pdtx * aire_prev *( CGAL::to_double(n_prev.x()))/volume_cel;
-	c.phi_y += c_prev.pdty * aire_prev *( CGAL::to_double(n_prev.y()))/volume_cel;
-	c.phi_z += c_prev.pdtz * aire_prev *( CGAL::to_double(n_prev.z()))/volume_cel;
+	w.phi_x += c_prev.pdtx * aire_prev *( CGAL::to_double(n_prev.x()))/volume_cel;
+	w.phi_y += c_prev.pdty * aire_prev *( CGAL::to_double(n_prev.y()))/volume_cel;
+	w.phi_z += c_prev.pdtz * aire_prev *( CGAL::to_double(n_prev.z()))/volume_cel;
 			
 	Vector_3 V_f = P.vitesse_parois_prev(center_prev);
-	c.phi_v += aire_prev * (CGAL::to_double(c.pdtx*n_prev.x()*V_f.x()  + c.pdty*n_prev.y()*V_f.y()+
+	w.phi_v += aire_prev * (CGAL::to_double(c.pdtx*n_prev.x()*V_f.x()  + c.pdty*n_prev.y()*V_f.y()+
 						c.pdtz*n_prev.z()*V_f.z()))/volume_cel;
-	grille[in1][jn1][kn1] = c;
       }
     }
     else {
@@ -1331,12 +1330,11 @@ void Grille::swap_face(const Triangles& T3d_prev, const Triangles& T3d_n, const
       if(norm2>eps){ 
 	Vector_3 n = norm/norm2;
 	double aire = sqrt(CGAL::to_double(T3d_n[i].squared_area()));
-	c.phi_x += c.pdtx * aire *( CGAL::to_double(n.x()))/(c.dx*c.dy*c.dz);
-	c.phi_y += c.pdty * aire *( CGAL::to_double(n.y()))/(c.dx*c.dy*c.dz);
-	c.phi_z += c.pdtz * aire *( CGAL::to_double(n.z()))/(c.dx*c.dy*c.dz);
+	w.phi_x += c.pdtx * aire *( CGAL::to_double(n.x()))/(c.dx*c.dy*c.dz);
+	w.phi_y += c.pdty * aire *( CGAL::to_double(n.y()))/(c.dx*c.dy*c.dz);
+	w.phi_z += c.pdtz * aire *( CGAL::to_double(n.z()))/(c.dx*c.dy*c.dz);
 	Vector_3 V_f = P.vitesse_parois(center_n);
-	c.phi_v += aire * (CGAL::to_double(c.pdtx*n.x()*V_f.x()  + c.pdty*n.y()*V_f.y() + c.pdtz*n.z()*V_f.z()))/(c.dx*c.dy*c.dz);
-	grille[in1][jn1][kn1] = c;
+	w.phi_v += aire * (CGAL::to_double(c.pdtx*n.x()*V_f.x()  + c.pdty*n.y()*V_f.y() + c.pdtz*n.z()*V_f.z()))/(c.dx*c.dy*c.dz);
       }
     } 
   } 
@@ -1364,7 +1362,7 @@ void Grille::swap_face(const Triangles& T3d_prev, const Triangles& T3d_n, const
  \warning <b> Specific coupling procedure ! </b>
  \return void
  */
-void Grille::swap_face_inexact(const Triangle_3& Tr_prev, const Triangle_3& Tr, const Triangles& T3d_prev, const Triangles& T3d_n, const double dt, Particule & P, double & volume_test){
+void Grille::swap_face_inexact(const Triangle_3& Tr_prev, const Triangle_3& Tr, const Triangles& T3d_prev, const Triangles& T3d_n, const double dt, Particule & P, Swap_accumulateur& acc){
   CGAL::Timer delta_time,total_time,boucle1_time,boucle2_time;
   delta_time.start();total_time.start();boucle1_time.start();boucle2_time.start();
   double temps_delta=0.,temps_total=0.,temps_boucle1=0.,temps_boucle2=0.,temps_intersections=0.,temps_triangulation=0.;
@@ -1411,7 +1409,7 @@ void Grille::swap_face_inexact(const Triangle_3& Tr_prev, const Triangle_3& Tr,
 	    if(CGAL::do_overlap(Tet[t].bbox(), box_cell)){
 	      double volume = (intersect_cube_tetrahedron(box_cell, Tet[t],temps_intersections,temps_triangulation) * sign(Tet[t].volume()) );
 	      
-	      volume_test += volume;
+	      acc.volume_test += volume;
 	      volume_tot += volume;
 	      volume_tet += volume;
 	      delta_w_tot[0] += volume*c.rho0; 
@@ -1474,18 +1472,19 @@ void Grille::swap_face_inexact(const Triangle_3& Tr_prev, const Triangle_3& Tr,
       }
     }
 		  
-    Cellule& c= grille[in1][jn1][kn1];
-    Cellule& c_prev= grille[in][jn][kn];
+    const Cellule& c= grille[in1][jn1][kn1];
+    Swap_contribution& w= acc.cellule(in1,jn1,kn1);
+    const Cellule& c_prev= grille[in][jn][kn];
     double volume_cel = c.dx*c.dy*c.dz;  
     if ((interieur==true)){ 
       double volume_p=volume_prisme(T3d_prev[i],T3d_n[i]);
       //Evaluation of the swept quantity as the product of the volume of the prism by the value of the fluid in the cell
       if( (std::abs(volume_p)>eps) && (std::abs(1.-c.alpha)>eps)){
-	c.delta_w[0] += volume_p*c_prev.rho0/volume_cel; 
-	c.delta_w[1] += volume_p*c_prev.impx0/volume_cel;
-	c.delta_w[2] += volume_p*c_prev.impy0/volume_cel; 
-	c.delta_w[3] += volume_p*c_prev.impz0/volume_cel; 
-	c.delta_w[4] += volume_p*c_prev.rhoE0/volume_cel;
+	w.delta_w[0] += volume_p*c_prev.rho0/volume_cel; 
+	w.delta_w[1] += volume_p*c_prev.impx0/volume_cel;
+	w.delta_w[2] += volume_p*c_prev.impy0/volume_cel; 
+	w.delta_w[3] += volume_p*c_prev.impz0/volume_cel; 
+	w.delta_w[4] += volume_p*c_prev.rhoE0/volume_cel;
 	volume_eval += abs(volume_p);
 	delta_w_tot[0] -= volume_p*c_prev.rho0; 
 	delta_w_tot[1] -= volume_p*c_prev.impx0;
@@ -1501,12 +1500,12 @@ void Grille::swap_face_inexact(const Triangle_3& Tr_prev, const Triangle_3& Tr,
       if(norm2_prev>eps){
 	Vector_3 n_prev = norm_prev/norm2_prev;
 	double aire_prev = sqrt(CGAL::to_double(T3d_prev[i].squared_area()));
-	c.phi_x += c_prev.pdtx * aire_prev *( CGAL::to_double(n_prev.x()))/volume_cel;
-	c.phi_y += c_prev.pdty * aire_prev *( CGAL::to_double(n_prev.y()))/volume_cel;
-	c.phi_z += c_prev.pdtz * aire_prev *( CGAL::to_double(n_prev.z()))/volume_cel;
+	w.phi_x += c_prev.pdtx * aire_prev *( CGAL::to_double(n_prev.x()))/volume_cel;
+	w.phi_y += c_prev.pdty * aire_prev *( CGAL::to_double(n_prev.y()))/volume_cel;
+	w.phi_z += c_prev.pdtz * aire_prev *( CGAL::to_double(n_prev.z()))/volume_cel;
 			
 	Vector_3 V_f = P.vitesse_parois_prev(center_prev);
-	c.phi_v += aire_prev * (CGAL::to_double(c.pdtx*n_prev.x()*V_f.x()  + c.pdty*n_prev.y()*V_f.y()+
+	w.phi_v += aire_prev * (CGAL::to_double(c.pdtx*n_prev.x()*V_f.x()  + c.pdty*n_prev.y()*V_f.y()+
 						c.pdtz*n_prev.z()*V_f.z()))/volume_cel;
       }
     }
@@ -1516,11 +1515,11 @@ void Grille::swap_face_inexact(const Triangle_3& Tr_prev, const Triangle_3& Tr,
       if(norm2>eps){ 
 	Vector_3 n = norm/norm2;
 	double aire = sqrt(CGAL::to_double(T3d_n[i].squared_area()));
-	c.phi_x += c.pdtx * aire *( CGAL::to_double(n.x()))/(c.dx*c.dy*c.dz);
-	c.phi_y += c.pdty * aire *( CGAL::to_double(n.y()))/(c.dx*c.dy*c.dz);
-	c.phi_z += c.pdtz * aire *( CGAL::to_double(n.z()))/(c.dx*c.dy*c.dz);
+	w.phi_x += c.pdtx * aire *( CGAL::to_double(n.x()))/(c.dx*c.dy*c.dz);
+	w.phi_y += c.pdty * aire *( CGAL::to_double(n.y()))/(c.dx*c.dy*c.dz);
+	w.phi_z += c.pdtz * aire *( CGAL::to_double(n.z()))/(c.dx*c.dy*c.dz);
 	Vector_3 V_f = P.vitesse_parois(center_n);
-	c.phi_v += aire * (CGAL::to_double(c.pdtx*n.x()*V_f.x()  + c.pdty*n.y()*V_f.y() + c.pdtz*n.z()*V_f.z()))/(c.dx*c.dy*c.dz);
+	w.phi_v += aire * (CGAL::to_double(c.pdtx*n.x()*V_f.x()  + c.pdty*n.y()*V_f.y() + c.pdtz*n.z()*V_f.z()))/(c.dx*c.dy*c.dz);
 	
       }
     } 
@@ -1565,14 +1564,15 @@ void Grille::swap_face_inexact(const Triangle_3& Tr_prev, const Triangle_3& Tr,
       }
     }
 		  
-    Cellule& c= grille[in1][jn1][kn1];
+    const Cellule& c= grille[in1][jn1][kn1];
+    Swap_contribution& w= acc.cellule(in1,jn1,kn1);
     double volume_cel = c.dx*c.dy*c.dz;  
     if ((interieur==true)){ 
       double volume_p=volume_prisme(T3d_prev[i],T3d_n[i]);
       //Evaluation of the swept quantity as the product of the volume of the prism by the value in the cell
       if( (std::abs(volume_p)>eps) && (std::abs(1.-c.alpha)>eps)){
 	for(int l=0;l<5;l++){
-	  c.delta_w[l] += abs(volume_p)/volume_eval*delta_w_tot[l]/volume_cel;
+	  w.delta_w[l] += abs(volume_p)/volume_eval*delta_w_tot[l]/volume_cel;
 	}
       }
     }
@@ -1580,15 +1580,51 @@ void Grille::swap_face_inexact(const Triangle_3& Tr_prev, const Triangle_3& Tr,
   temps_boucle2 += boucle2_time.time();
 }	
 
+/*!\brief Angular order of 2d points around a point \a g.
+   \details Exact comparison using function <b> CGAL::orientation(Point_2, Point_2, Point_2)</b>: the points are first split into the half-planes above and below \a g, then sorted counterclockwise in each half-plane.
+*/
+struct Ordre_angulaire_2d
+{
+  Point_2 g; //!< Center of the angular order
+  Ordre_angulaire_2d(const Point_2& g0): g(g0) {}
+  int demi_plan(const Point_2& a) const {
+    return ((a.y() > g.y()) || ((a.y() == g.y()) && (a.x() > g.x()))) ? 0 : 1;
+  }
+  bool operator()(const Point_2& a, const Point_2& b) const {
+    const int da = demi_plan(a), db = demi_plan(b);
+    if(da != db){ return da < db; }
+    return CGAL::orientation(g, a, b) == CGAL::LEFT_TURN;
+  }
+};
+
+/*!\brief Triangulation of a 2d convex polygon.
+   \details The vertices of the polygon are sorted counterclockwise around their centroid (\a Ordre_angulaire_2d) and the polygon is split into a fan of triangles from its first vertex. The triangles of area smaller than \a eps (repeated or aligned vertices) are discarded.
+   \param vPoints vertices of the convex polygon, in any order
+   \param tri2 Triangles_2: the triangles are appended to \a tri2
+   \warning <b> Specific coupling procedure ! </b>
+   \return void
+*/
+void triangulation_polygone_convexe_2d(std::vector<Point_2>& vPoints, Triangles_2& tri2){
+  if(vPoints.size() < 3){ return; }
+  const Point_2 g = CGAL::centroid(vPoints.begin(), vPoints.end());
+  std::sort(vPoints.begin(), vPoints.end(), Ordre_angulaire_2d(g));
+  for(int l=1; l+1<vPoints.size(); l++){
+    const Triangle_2 tri(vPoints[0], vPoints[l], vPoints[l+1]);
+    if(tri.area()>eps){
+      tri2.push_back(tri);
+    }
+  }
+}
+
 /*!\brief Construction of the 2d submesh of two meshes on a triangular 2d face of the solid.
    \details The goal is to split the solid face into interface triangles such that each triangle is fully enclosed in one single cell at times t-dt and t (npt necessarily the same cell).\n
    Algorithm:\n
-   - Construct the 2d bounding box for each triangle.  \n
-   - Loop on the bounding boxes.
+   - Sort the triangles of \a Tn1 in a uniform 2d binning of the bounding box of \a Tn1 (about one triangle per bin), using their 2d bounding boxes. \n
+   - Loop on the triangles of \a Tn. The candidate triangles of \a Tn1 are the ones sorted in the bins overlapped by the bounding box of the triangle (taken in increasing order, so that the submesh does not depend on the binning).
    - Test the intersection of the bounding boxes using function <b> CGAL::do_overlap(Bbox_2, Bbox_2)</b>. If the boxes intersect: \n
    - Test the intersection of the triangles using function <b> CGAL::do_intersect(Triangle_2,Triangle_2)</b>. If the triangles intersect:  \n
    - Compute the intersections between the two triangles using function <b>CGAL::intersection(Triangle_2,Triangle_2)</b>. \n
-   - If the intersection is a triangle, add it to the submesh. If the intersection is a polygon, triangulate it using class <b>CGAL::Triangulation</b> and function <b> CGAL::insert </b> in the class. If the intersection is a point or a segment, do nothing since the swept volume is null.
+   - If the intersection is a triangle, add it to the submesh. If the intersection is a polygon (necessarily convex), triangulate it using function \a triangulation_polygone_convexe_2d(std::vector<Point_2>&, Triangles_2&). If the intersection is a point or a segment, do nothing since the swept volume is null.
    \warning <b> Specific coupling procedure ! </b>
    \param Tn Triangles_2 
    \param Tn1 Triangles_2
@@ -1599,24 +1635,61 @@ void Sous_Maillage_2d(const Triangles_2& Tn, const Triangles_2& Tn1, Triangles_2
 	
   Triangle_2 tri;
   std::vector<Point_2> vPoints; 
-  int k=0;
-  CGAL::Timer user_time;
-  user_time.start();
-  for(Triangles_2::const_iterator t=Tn.begin(); t!=Tn.end(); t++){ 
-    for(Triangles_2::const_iterator t1=Tn1.begin(); t1!=Tn1.end(); t1++){
-      if (CGAL::do_overlap((*t).bbox(),(*t1).bbox())){ //test the intersection of Bbox 
-	if (CGAL::do_intersect(*t,*t1)){ // test the intersection of the triangles
-	  const CGAL::Object& result = CGAL::intersection(*t,*t1); //Compute the intersection between two triangles
+  if(Tn.size()==0 || Tn1.size()==0){ return; }
+  
+  //Binning of Tn1
+  std::vector<Bbox_2> box_Tn1(Tn1.size());
+  Bbox_2 box_tot = Tn1[0].bbox();
+  for(int l=0; l<Tn1.size(); l++){
+    box_Tn1[l] = Tn1[l].bbox();
+    box_tot = box_tot + box_Tn1[l];
+  }
+  const int nb = std::max(1, int(sqrt(double(Tn1.size()))));
+  const double hx = std::max((box_tot.xmax()-box_tot.xmin())/nb, eps);
+  const double hy = std::max((box_tot.ymax()-box_tot.ymin())/nb, eps);
+  std::vector< std::vector<int> > bins(nb*nb);
+  for(int l=0; l<Tn1.size(); l++){
+    const int imin = std::max(0, std::min(nb-1, int((box_Tn1[l].xmin()-box_tot.xmin())/hx)));
+    const int imax = std::max(0, std::min(nb-1, int((box_Tn1[l].xmax()-box_tot.xmin())/hx)));
+    const int jmin = std::max(0, std::min(nb-1, int((box_Tn1[l].ymin()-box_tot.ymin())/hy)));
+    const int jmax = std::max(0, std::min(nb-1, int((box_Tn1[l].ymax()-box_tot.ymin())/hy)));
+    for(int i=imin; i<=imax; i++){
+      for(int j=jmin; j<=jmax; j++){
+	bins[i*nb+j].push_back(l);
+      }
+    }
+  }
+  
+  std::vector<int> visite(Tn1.size(), -1);
+  std::vector<int> candidats;
+  for(int l=0; l<Tn.size(); l++){ 
+    const Bbox_2 box = Tn[l].bbox();
+    if(!CGAL::do_overlap(box, box_tot)){ continue; }
+    const int imin = std::max(0, std::min(nb-1, int((box.xmin()-box_tot.xmin())/hx)));
+    const int imax = std::max(0, std::min(nb-1, int((box.xmax()-box_tot.xmin())/hx)));
+    const int jmin = std::max(0, std::min(nb-1, int((box.ymin()-box_tot.ymin())/hy)));
+    const int jmax = std::max(0, std::min(nb-1, int((box.ymax()-box_tot.ymin())/hy)));
+    candidats.clear();
+    for(int i=imin; i<=imax; i++){
+      for(int j=jmin; j<=jmax; j++){
+	const std::vector<int>& bin = bins[i*nb+j];
+	for(int m=0; m<bin.size(); m++){
+	  if(visite[bin[m]] != l){
+	    visite[bin[m]] = l;
+	    candidats.push_back(bin[m]);
+	  }
+	}
+      }
+    }
+    std::sort(candidats.begin(), candidats.end());
+    for(int m=0; m<candidats.size(); m++){
+      const Triangle_2& t1 = Tn1[candidats[m]];
+      if (CGAL::do_overlap(box, box_Tn1[candidats[m]])){ //test the intersection of Bbox 
+	if (CGAL::do_intersect(Tn[l],t1)){ // test the intersection of the triangles
+	  const CGAL::Object& result = CGAL::intersection(Tn[l],t1); //Compute the intersection between two triangles
 	  if(CGAL::assign(tri,result)){ tri2.push_back(tri); }
 	  else if(CGAL::assign(vPoints,result)){
-	    Triangulation_2 T;
-	    T.insert(vPoints.begin(), vPoints.end());
-	    for (Triangulation_2::Finite_faces_iterator fit=T.finite_faces_begin(); fit!=T.finite_faces_end();++fit)
-	    { 
-	      if(T.triangle(fit).area()>eps){
-		tri2.push_back(T.triangle(fit));
-	      }
-	    }
+	    triangulation_polygone_convexe_2d(vPoints, tri2);
 	  }
 	}
       }
@@ -1691,11 +1764,39 @@ void sous_maillage_faceTn_faceTn1_2d(const Triangle_3& Tn, const Triangles& tn,
   temps_2d_3d_bis += time_2d_3d_bis.time();
 }
 
+/*!\brief Constructor of an empty accumulator.
+ */
+Swap_accumulateur::Swap_accumulateur(){
+  volume_test = 0.;
+}
+
+/*!\brief Contribution to cell (i,j,k), created with zero values at first access.
+   \param i,j,k indices of the fluid cell
+   \warning The returned reference is invalidated by the next access to a new cell.
+   \return Swap_contribution&
+*/
+Swap_contribution& Swap_accumulateur::cellule(const int i, const int j, const int k){
+  const int l = (i*(Ny+2*marge) + j)*(Nz+2*marge) + k;
+  std::map<int,int>::iterator it = index.find(l);
+  if(it != index.end()){
+    return contributions[it->second];
+  }
+  Swap_contribution w;
+  w.i = i; w.j = j; w.k = k;
+  for(int m=0;m<5;m++){ w.delta_w[m] = 0.; }
+  w.phi_x = w.phi_y = w.phi_z = w.phi_v = 0.;
+  index[l] = contributions.size();
+  contributions.push_back(w);
+  return contributions.back();
+}
+
 /*!\brief Computation of the quantity of fluid swept by the solid between times t-dt and t.
    \details Algorithm:\n
    - Split the solid faces (\a Particule.triangles and \a Particule.triangles_prev) into triangles fully contained in one single cell at times t-dt and t (not necessarily the same cell) using function \a sous_maillage_faceTn_faceTn1_2d(Triangle_3&, Triangles&, Triangle_3&, Triangles&, Vector_3& ,Triangles& ,Triangles&).\n
-   - Compute the swept quantity and the boundary flux using function \a swap_face(Triangles&, Triangles&, const double ,  Particule &).
+   - Compute the swept quantity and the boundary flux using function \a swap_face(Triangles&, Triangles&, const double ,  Particule &, Swap_accumulateur&).\n
+   Each face in contact with the fluid accumulates its contributions in its own \a Swap_accumulateur, and the accumulators are added to the fluid cells afterwards in the order of the faces, so that the result does not depend on the order in which the faces are processed.
    \warning <b> Specific coupling procedure ! </b> 
+   \warning The faces are processed in parallel (OpenMP) only when compiling with -fopenmp -DCELIA3D_SWAP_PARALLELE: the faces of a particle share its lazy exact objects (\a Particule.mvt_t, vertices of the triangles), which requires a CGAL whose lazy exact kernel is thread-safe.
    \param S Solide
    \param dt Time-step
    \return void
@@ -1703,37 +1804,71 @@ void sous_maillage_faceTn_faceTn1_2d(const Triangle_3& Tn, const Triangles& tn,
 
 void Grille::Swap_2d(const double dt, Solide& S){
 	
-  CGAL::Timer swap_face_time,total_time,sous_maillage_time;
-  swap_face_time.start();total_time.start();sous_maillage_time.start();
+  CGAL::Timer total_time;
+  total_time.start();
   double temps_swap_face=0.,temps_total=0.,temps_sous_maillage=0.,nb=0.;
   double volume_test=0.;
+  
+  //List of the faces in contact with the fluid
+  std::vector<int> faces_particule, faces_triangle;
   for(int i=0;i<S.solide.size();i++){
     for (int j=0; j<S.solide[i].triangles.size(); j++){
       if (S.solide[i].fluide[j]){
-	nb+=1.;
-	Triangles T3d_n,T3d_n1;
-	sous_maillage_time.reset();
-	sous_maillage_faceTn_faceTn1_2d(S.solide[i].triangles_prev[j], S.solide[i].Triangles_interface_prev[j], S.solide[i].triangles[j], S.solide[i].Triangles_interface[j], S.solide[i].normales[j], T3d_n, T3d_n1);
-	temps_sous_maillage += sous_maillage_time.time();
-	swap_face_time.reset();
-	if(exact_swap){
-	  //Exact swept quantity
-	  swap_face(T3d_n,T3d_n1,dt, S.solide[i],volume_test );
-	} else {
-	  //Inexact swept quantity: compute the swept quatity inexactly and distribute the default of fluid on the interface elements
-	  swap_face_inexact(S.solide[i].triangles_prev[j],S.solide[i].triangles[j],T3d_n,T3d_n1,dt,S.solide[i],volume_test);
-	}
-	temps_swap_face += swap_face_time.time();
+	faces_particule.push_back(i);
+	faces_triangle.push_back(j);
+      }
+    }
+  }
+  const int nb_faces = faces_particule.size();
+  nb = nb_faces;
+  std::vector<Swap_accumulateur> acc(nb_faces);
+  
+#ifdef CELIA3D_SWAP_PARALLELE
+#pragma omp parallel for schedule(dynamic) reduction(+:temps_sous_maillage,temps_swap_face)
+#endif
+  for(int f=0;f<nb_faces;f++){
+    const int i = faces_particule[f];
+    const int j = faces_triangle[f];
+    CGAL::Timer face_time;
+    face_time.start();
+    Triangles T3d_n,T3d_n1;
+    sous_maillage_faceTn_faceTn1_2d(S.solide[i].triangles_prev[j], S.solide[i].Triangles_interface_prev[j], S.solide[i].triangles[j], S.solide[i].Triangles_interface[j], S.solide[i].normales[j], T3d_n, T3d_n1);
+    temps_sous_maillage += face_time.time();
+    face_time.reset();
+    if(exact_swap){
+      //Exact swept quantity
+      swap_face(T3d_n,T3d_n1,dt, S.solide[i],acc[f]);
+    } else {
+      //Inexact swept quantity: compute the swept quatity inexactly and distribute the default of fluid on the interface elements
+      swap_face_inexact(S.solide[i].triangles_prev[j],S.solide[i].triangles[j],T3d_n,T3d_n1,dt,S.solide[i],acc[f]);
+    }
+    temps_swap_face += face_time.time();
+  }
+  
+  //Deterministic reduction on the fluid cells, in the order of the faces
+  for(int f=0;f<nb_faces;f++){
+    for(int l=0;l<acc[f].contributions.size();l++){
+      const Swap_contribution& w = acc[f].contributions[l];
+      Cellule& c = grille[w.i][w.j][w.k];
+      for(int m=0;m<5;m++){
+	c.delta_w[m] += w.delta_w[m];
       }
+      c.phi_x += w.phi_x;
+      c.phi_y += w.phi_y;
+      c.phi_z += w.phi_z;
+      c.phi_v += w.phi_v;
     }
+    volume_test += acc[f].volume_test;
   }
   temps_total += total_time.time();
-  cout << "################# COUT SWAP ##############" << endl;
-  cout << "sous_maillage=" << 100*temps_sous_maillage/temps_total << "%     t_moy=" << temps_sous_maillage/nb << " nb=" << nb << endl;
-  cout << "swap_face=" << 100*temps_swap_face/temps_total << "%     t_moy=" << temps_swap_face/nb << " nb=" << nb << endl;
-  cout << "Reste=" << 100*(1.-(temps_sous_maillage+temps_swap_face)/temps_total) << "%" << endl;
-  cout << "##########################################" << endl;
-  cout<<"volume balayee = "<< volume_test<<endl;
+  if(journal.actif(journal_couts,journal_detail)){
+    journal.flux() << "################# COUT SWAP ##############" << "\n";
+    journal.flux() << "sous_maillage=" << 100*temps_sous_maillage/temps_total << "%     t_moy=" << temps_sous_maillage/nb << " nb=" << nb << "\n";
+    journal.flux() << "swap_face=" << 100*temps_swap_face/temps_total << "%     t_moy=" << temps_swap_face/nb << " nb=" << nb << "\n";
+    journal.flux() << "Reste=" << 100*(1.-(temps_sous_maillage+temps_swap_face)/temps_total) << "%" << "\n";
+    journal.flux() << "##########################################" << "\n";
+  }
+  JOURNAL(journal_couplage,journal_diagnostic)<<"volume balayee = "<< volume_test<<"\n";
 }
 
 
@@ -1871,7 +2006,7 @@ void Grille::Mixage_cible(){
 bool Grille::Mixage_cible2(){
   //Test whether there are still negative densities or pressure after mixing
   bool test_fini = true;
-  cout << "Mixage_cible2" << endl;
+  JOURNAL(journal_couplage,journal_detail) << "Mixage_cible2" << "\n";
   //Step 0: initialize
   for(int i=0;i<Nx+2*marge;i++){
     for(int j=0;j<Ny+2*marge;j++){ 
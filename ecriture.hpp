@@ -0,0 +1,149 @@
+//Copyright 2017 Laurent Monasse
+
+/*
+  This file is part of CELIA3D.
+  
+  CELIA3D is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  CELIA3D is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  
+  You should have received a copy of the GNU General Public License
+  along with CELIA3D.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+   \file
+   \authors Laurent Monasse and Maria Adela Puscas
+   \brief Writing of the output files in a background thread.
+ */
+
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "parametres.hpp"
+#include "fluide.hpp"
+#include "solide.hpp"
+#include "sortie_hdf5.hpp"
+
+#ifndef ECRITURE_HPP
+#define ECRITURE_HPP
+
+/*!\brief Writing of the output files fluide<n>.vtk and solide<n>.vtk in a background thread.
+
+At output time, the fields are copied in an \a Instantane_fluide and an \a Instantane_solide by the computing thread, then written by the writing thread while the time-stepping goes on. At most \a taille_file_ecriture outputs wait in the queue: beyond, \a Ecriture_asynchrone.Ajoute waits for the writing of the oldest one. If \a ecriture_asynchrone is false, the outputs are written directly. With \a sortie_hdf5, the outputs are appended to resultats/resultats.h5 instead (see \a Sortie_hdf5).
+*/
+class Ecriture_asynchrone
+{
+public:
+  /*!\brief Constructor.
+    \param reprise true if the computation restarts: the HDF5 file and solide_trajectoire.bin are then completed instead of being created again
+    \param premiere_sortie index of the first output of the restarted computation (see \a Sortie_hdf5)
+  */
+  Ecriture_asynchrone(const bool reprise, const int premiere_sortie): fin(false), hdf5(reprise,premiere_sortie), trajectoire(reprise) {
+    if(sortie_hdf5 && !Sortie_hdf5::disponible){
+      std::cout << "HDF5 outputs not compiled (-DCELIA3D_HDF5): files fluide*.vtk and solide*.vtk written instead" << std::endl;
+    }
+  }
+  ~Ecriture_asynchrone(){ Termine(); }
+  
+  /*!\brief Adds the output of index \a n of the fluid \a Fluide and of the solid \a S.
+    \param Fluide fluid
+    \param S solid
+    \param n index of the output files
+    \param t time of the output
+    \return void
+  */
+  void Ajoute(Grille& Fluide, Solide& S, const int n, const double t){
+    Sortie sortie;
+    sortie.t = t;
+    Fluide.Instantane(sortie.fluide,n);
+    S.Instantane(sortie.solide,n);
+    if(!ecriture_asynchrone){
+      Ecrit(sortie);
+      return;
+    }
+    std::unique_lock<std::mutex> verrou(acces);
+    if(!ecrivain.joinable()){
+      fin = false;
+      ecrivain = std::thread(&Ecriture_asynchrone::Boucle, this);
+    }
+    non_pleine.wait(verrou, [this]{ return int(file.size()) < taille_file_ecriture; });
+    file.push_back(Sortie());
+    std::swap(file.back(), sortie);
+    non_vide.notify_one();
+  }
+  
+  //! \brief Waits for the writing of all the outputs in the queue and stops the writing thread
+  void Termine(){
+    {
+      std::lock_guard<std::mutex> verrou(acces);
+      fin = true;
+    }
+    non_vide.notify_one();
+    if(ecrivain.joinable()){
+      ecrivain.join();
+    }
+  }
+  
+private:
+  //! \brief Output of the fluid and of the solid at the same time
+  struct Sortie
+  {
+    Instantane_fluide fluide;
+    Instantane_solide solide;
+    double t;
+  };
+  
+  //! \brief Writes the files of the output \a sortie
+  void Ecrit(const Sortie& sortie){
+    if(sortie_hdf5 && Sortie_hdf5::disponible){
+      hdf5.Ecrit(sortie.fluide,sortie.solide,sortie.t);
+    } else {
+      Ecrit_instantane(sortie.fluide);
+      Ecrit_instantane(sortie.solide);
+    }
+    if(trajectoire_solide){
+      trajectoire.Ajoute(sortie.solide,sortie.t);
+    }
+  }
+  
+  //! \brief Loop of the writing thread: writes the outputs in the order of the queue
+  void Boucle(){
+    while(true){
+      Sortie sortie;
+      {
+	std::unique_lock<std::mutex> verrou(acces);
+	non_vide.wait(verrou, [this]{ return fin || !file.empty(); });
+	if(file.empty()){
+	  return;
+	}
+	std::swap(sortie, file.front());
+      }
+      Ecrit(sortie);
+      {
+	//The output leaves the queue once written, so that the queue bounds the memory of the outputs
+	std::lock_guard<std::mutex> verrou(acces);
+	file.pop_front();
+      }
+      non_pleine.notify_one();
+    }
+  }
+  
+  std::deque<Sortie> file;             //!< Outputs waiting for writing
+  std::mutex acces;                    //!< Access to \a file and \a fin
+  std::condition_variable non_vide;    //!< Signals a new output or the end
+  std::condition_variable non_pleine;  //!< Signals the end of the writing of an output
+  std::thread ecrivain;                //!< Writing thread
+  bool fin;                            //!< End of the writing requested
+  Sortie_hdf5 hdf5;                    //!< HDF5 file, used by the writing thread only
+  Trajectoire_solide trajectoire;      //!< Positions of the solid vertices, used by the writing thread only
+};
+
+#endif
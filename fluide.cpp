@@ -28,6 +28,7 @@
 #include <stdio.h> 
 #include <fstream> 
 #include <math.h> 
+#include <limits>
 #include "fluide.hpp"
 
 
@@ -453,6 +454,33 @@ void Cellule::Affiche (){
   cout<<" cell state: vide "<<vide<<endl;  
 }
 
+/*!\brief Lax-Friedrichs flux at the interface with the neighbouring cell \a cv, used when the Roe linearization fails.
+   \details \a flux contains the centered flux on entry. The higher-order corrections of the cell are set to zero, so that the limiter adds nothing at this interface.
+   \param cv neighbouring cell
+   \param flux numerical flux at the interface (\a fluxi, \a fluxj or \a fluxk)
+   \param sigma time-step/fluid spatial discretization step
+   \return void
+*/
+void Cellule::Flux_Lax_Friedrichs(const Cellule& cv, double* flux, const double sigma){
+  flux[0] += (rho - cv.rho)/2./sigma;
+  flux[1] += (impx - cv.impx)/2./sigma;
+  flux[2] += (impy - cv.impy)/2./sigma;
+  flux[3] += (impz - cv.impz)/2./sigma;
+  flux[4] += (rhoE - cv.rhoE)/2./sigma;
+  for(int l=0;l<5;l++){
+    lambda[l] = 0.;
+    delw[l] = delwnu[l] = 0.;
+    cf2[l] = cf3[l] = cf4[l] = cf5[l] = cf6[l] = cf7[l] = cf8[l] = cf9[l] = cf10[l] = cf11[l] = 0.;
+    psic0[l] = psic1[l] = psic2[l] = psic3[l] = psic4[l] = 0.;
+    psid0[l] = psid1[l] = psid2[l] = psid3[l] = psid4[l] = 0.;
+    psic0r[l] = psic1r[l] = psic2r[l] = psic3r[l] = psic4r[l] = 0.;
+    psid0r[l] = psid1r[l] = psid2r[l] = psid3r[l] = psid4r[l] = 0.;
+    for(int m=0;m<5;m++){
+      vpr[m][l] = 0.;
+    }
+  }
+}
+
 
 //Definition of the methods of class Grille 
 
@@ -725,6 +753,81 @@ double Grille::Energie(){
   }
   return E; 
 } 
+/*!\brief Computation of the fluid mass, momentum and energy in one pass on the grid.
+   \details The planes i = const are processed in parallel, each with a compensated summation (\a Somme_compensee), and their sums are added in the order of i, so that the result does not depend on the number of threads.
+   \param m total fluid mass
+   \param impx total fluid x-momentum
+   \param impy total fluid y-momentum
+   \param impz total fluid z-momentum
+   \param E total fluid energy
+   \param cumuls pressure accumulators updated in the same pass (none if NULL)
+   \param dt time-step ended (the accumulators are not updated if dt = 0)
+   \return void
+*/
+void Grille::Bilan_fluide(double& m, double& impx, double& impy, double& impz, double& E, Cumuls_fluide* cumuls, const double dt){
+  std::vector<Somme_compensee> sommes(5*Nx);
+  const bool cumul = (cumuls!=NULL && dt>0.);
+#pragma omp parallel for schedule(static)
+  for(int i=marge;i<Nx+marge;i++){
+    Somme_compensee* s = &sommes[5*(i-marge)];
+    int l = (i-marge)*Ny*Nz;
+    for(int j=marge;j<Ny+marge;j++){
+      for(int k=marge;k<Nz+marge;k++,l++){
+	const Cellule& c = grille[i][j][k];
+	const double vol = c.dx*c.dy*c.dz*(1.-c.alpha);
+	s[0].ajoute(c.rho*vol);
+	s[1].ajoute(c.impx*vol);
+	s[2].ajoute(c.impy*vol);
+	s[3].ajoute(c.impz*vol);
+	s[4].ajoute(c.rhoE*vol);
+	if(cumul){
+	  const double impulsions[4] = {c.p*dt, c.pdtx, c.pdty, c.pdtz};
+	  for(int q=0;q<4;q++){
+	    const double pression = impulsions[q]/dt;
+	    cumuls->integrale[q][l] += impulsions[q];
+	    cumuls->maximum[q][l] = std::max(cumuls->maximum[q][l],pression);
+	    cumuls->minimum[q][l] = std::min(cumuls->minimum[q][l],pression);
+	  }
+	}
+      }
+    }
+  }
+  if(cumul){
+    cumuls->duree += dt;
+  }
+  Somme_compensee total[5];
+  for(int i=0;i<Nx;i++){
+    for(int l=0;l<5;l++){
+      total[l].ajoute(sommes[5*i+l]);
+    }
+  }
+  m = total[0].valeur();
+  impx = total[1].valeur();
+  impy = total[2].valeur();
+  impz = total[3].valeur();
+  E = total[4].valeur();
+}
+
+/*!\brief Default constructor.
+ */
+Bilan::Bilan(){
+  masse = impx = impy = impz = 0.;
+  energie_fluide = energie_cinetique = energie_potentielle = 0.;
+}
+
+/*!\brief Computation of the global balances of the fluid and of the solid.
+   \param Fluide fluid grid
+   \param S solid
+   \param cumuls pressure accumulators updated in the same pass on the fluid grid (none if NULL)
+   \param dt time-step ended
+   \return void
+*/
+void Bilan::Calcul(Grille& Fluide, Solide& S, Cumuls_fluide* cumuls, const double dt){
+  Fluide.Bilan_fluide(masse,impx,impy,impz,energie_fluide,cumuls,dt);
+  energie_cinetique = S.Energie_cinetique();
+  energie_potentielle = S.Energie_potentielle();
+}
+
 /*!\brief Mixing the cells with negative density or pressure with neighbours. 
    \param dt time-step
    \return void
@@ -1275,28 +1378,12 @@ void Grille::fnumx(const double sigma, double t){
 										
 	  //Test on the sound velocity 
 	  if(cr2<=0. && abs(c.alpha-1.)>eps){
-	    cout << "x-flux computation" << endl;
-	    cout << "i=" << i << " j=" << j << " k=" << k<< " negative speed of sound : c2=" << cr2 << endl;
-	    cout << "x=" << c.x << " y=" << c.y << " z=" << c.z<< " alpha=" << c.alpha << endl;
-	    cout << "t=" << t << endl; 
-	    cout << "c.p=" << c.p << endl; 
-	    cout << "c.rho=" << c.rho << endl; 
-	    cout << "c.u=" << c.u << endl; 
-	    cout << "c.v=" << c.v << endl; 
-	    cout << "c.w=" << c.w << endl; 
-	    cout << "ci.p=" << ci.p << endl; 
-	    cout << "ci.rho=" << ci.rho << endl; 
-	    cout << "ci.u=" << ci.u << endl;
-	    cout << "ci.v=" << ci.v << endl;
-	    cout << "ci.w=" << ci.w << endl;
-	    cout << "ur=" << ur << endl; 
-	    cout << "ur2=" << ur2 << endl; 
-	    cout << "vr=" << vr << endl; 
-	    cout << "vr2=" << vr2 << endl; 
-	    cout << "wr2=" << wr2 << endl; 
-	    cout << "Hr=" << Hr << endl;
-	    getchar();
-	  } 
+	    anomalies.Signale(anomalie_vitesse_son_x,t) << "i=" << i << " j=" << j << " k=" << k << " c2=" << cr2 << " x=" << c.x << " y=" << c.y << " z=" << c.z << " alpha=" << c.alpha << " p=" << c.p << " rho=" << c.rho << " u=" << c.u << " v=" << c.v << " w=" << c.w << " ci.p=" << ci.p << " ci.rho=" << ci.rho << " ci.u=" << ci.u << " ci.v=" << ci.v << " ci.w=" << ci.w << " ur=" << ur << " vr=" << vr << " wr=" << wr << " Hr=" << Hr << "\n";
+	    if(politique_anomalie==anomalie_lax_friedrichs){
+	      c.Flux_Lax_Friedrichs(ci,c.fluxi,sigma);
+	      continue;
+	    }
+	  }
 										
 	  //Speed of sound
 	  double cr = sqrt(cr2);
@@ -1643,8 +1730,7 @@ void Grille::fnumx(const double sigma, double t){
 	Cellule& c = grille[i][j][k];
 	if(c.y>0.2 || c.y<0.1 || c.z<0.09 || c.x>0.1){
 	  if(c.p<eps || c.rho<eps){
-	    cout << "p or rho negative : p " << c.p << " rho " << c.rho;
-	    getchar();
+	    anomalies.Signale(anomalie_pression_densite,t) << "i=" << i << " j=" << j << " k=" << k << " p=" << c.p << " rho=" << c.rho << "\n";
 	  }
 	  double cr = sqrt(gam*c.p/c.rho);
 	  Cellule& cg = grille[i-1][j][k];
@@ -1722,8 +1808,7 @@ void Grille::fnumx(const double sigma, double t){
 	Cellule& c = grille[i][j][k];
 	if(c.y>0.2 || c.y<0.1 || c.z<0.09 || c.x>0.1){
 	  if(c.p<eps || c.rho<eps){
-	    cout << "p or rho negative : p " << c.p << " rho " << c.rho;
-	    getchar();
+	    anomalies.Signale(anomalie_pression_densite,t) << "i=" << i << " j=" << j << " k=" << k << " p=" << c.p << " rho=" << c.rho << "\n";
 	  }
 	  Cellule& cd = grille[i+1][j][k];
 	  Cellule& cd2 = grille[i+2][j][k];
@@ -1866,28 +1951,12 @@ void Grille::fnumy(const double sigma, double t){
 									
 	  //Test on the speed of sound
 	  if(cr2<=0. && abs(c.alpha-1.)>eps){
-	    cout << "computation of the y-flux" << endl;
-	    cout << "i=" << i << " j=" << j <<" k = "<<k<< " negative speed of sound: c2=" << cr2 << endl;
-	    cout << "x=" << c.x << " y=" << c.y << " z=" << c.z << " alpha=" << c.alpha << endl;
-	    cout << "t=" << t << endl; 
-	    cout << "c.p=" << c.p << endl; 
-	    cout << "c.rho=" << c.rho << endl; 
-	    cout << "c.u=" << c.u << endl; 
-	    cout << "c.v=" << c.v << endl; 
-	    cout << "c.w=" << c.w << endl; 
-	    cout << "cj.p=" << cj.p << endl; 
-	    cout << "cj.rho=" << cj.rho << endl; 
-	    cout << "cj.u=" << cj.u << endl;
-	    cout << "cj.v=" << cj.v << endl;
-	    cout << "cj.w=" << cj.w << endl;
-	    cout << "ur=" << ur << endl; 
-	    cout << "ur2=" << ur2 << endl; 
-	    cout << "vr=" << vr << endl; 
-	    cout << "vr2=" << vr2 << endl; 
-	    cout << "wr2=" << wr2 << endl; 
-	    cout << "Hr=" << Hr << endl;
-	    getchar(); 
-	  } 
+	    anomalies.Signale(anomalie_vitesse_son_y,t) << "i=" << i << " j=" << j << " k=" << k << " c2=" << cr2 << " x=" << c.x << " y=" << c.y << " z=" << c.z << " alpha=" << c.alpha << " p=" << c.p << " rho=" << c.rho << " u=" << c.u << " v=" << c.v << " w=" << c.w << " cj.p=" << cj.p << " cj.rho=" << cj.rho << " cj.u=" << cj.u << " cj.v=" << cj.v << " cj.w=" << cj.w << " ur=" << ur << " vr=" << vr << " wr=" << wr << " Hr=" << Hr << "\n";
+	    if(politique_anomalie==anomalie_lax_friedrichs){
+	      c.Flux_Lax_Friedrichs(cj,c.fluxj,sigma);
+	      continue;
+	    }
+	  }
 									
 	  //Speed of sound 
 	  double cr = sqrt(cr2); 
@@ -2221,8 +2290,7 @@ void Grille::fnumy(const double sigma, double t){
       for(int i=0;i<Nx+2*marge;i++){
 	Cellule& c = grille[i][j][k];
 	if(c.p<eps || c.rho<eps){
-	  cout << "p or rho negative: p " << c.p << " rho " << c.rho;
-	  getchar();
+	  anomalies.Signale(anomalie_pression_densite,t) << "i=" << i << " j=" << j << " k=" << k << " p=" << c.p << " rho=" << c.rho << "\n";
 	}
 	double cr = sqrt(gam*c.p/c.rho);
 	Cellule& cg = grille[i][j-1][k];
@@ -2298,8 +2366,7 @@ void Grille::fnumy(const double sigma, double t){
       for(int i=0;i<Nx+2*marge;i++){
 	Cellule& c = grille[i][j][k];
 	if(c.p<eps || c.rho<eps){
-	  cout << "p or rho negative: p " << c.p << " rho " << c.rho;
-	  getchar();
+	  anomalies.Signale(anomalie_pression_densite,t) << "i=" << i << " j=" << j << " k=" << k << " p=" << c.p << " rho=" << c.rho << "\n";
 	}
 	Cellule& cd = grille[i][j+1][k];
 	Cellule& cd2 = grille[i][j+2][k];
@@ -2444,28 +2511,12 @@ void Grille::fnumz(const double sigma, double t){
 									
 	  //Test on the speed of sound
 	  if(cr2<=0. && abs(c.alpha-1.)>eps){
-	    cout << "COmputation of the z-flux" << endl;
-	    cout << "i=" << i << " j=" << j << " negative speed of sound: c2=" << cr2 << endl;
-	    cout << "x=" << c.x << " y=" << c.y << " z=" << c.z << " alpha=" << c.alpha << endl;
-	    cout << "t=" << t << endl; 
-	    cout << "c.p=" << c.p << endl; 
-	    cout << "c.rho=" << c.rho << endl; 
-	    cout << "c.u=" << c.u << endl; 
-	    cout << "c.v=" << c.v << endl; 
-	    cout << "c.w=" << c.w << endl; 
-	    cout << "ck.p=" << ck.p << endl; 
-	    cout << "ck.rho=" << ck.rho << endl; 
-	    cout << "ck.u=" << ck.u << endl;
-	    cout << "ck.v=" << ck.v << endl;
-	    cout << "ck.w=" << ck.w << endl;
-	    cout << "ur=" << ur << endl; 
-	    cout << "ur2=" << ur2 << endl; 
-	    cout << "vr=" << vr << endl; 
-	    cout << "vr2=" << vr2 << endl; 
-	    cout << "wr2=" << wr2 << endl; 
-	    cout << "Hr=" << Hr << endl;
-	    getchar(); 
-	  } 
+	    anomalies.Signale(anomalie_vitesse_son_z,t) << "i=" << i << " j=" << j << " k=" << k << " c2=" << cr2 << " x=" << c.x << " y=" << c.y << " z=" << c.z << " alpha=" << c.alpha << " p=" << c.p << " rho=" << c.rho << " u=" << c.u << " v=" << c.v << " w=" << c.w << " ck.p=" << ck.p << " ck.rho=" << ck.rho << " ck.u=" << ck.u << " ck.v=" << ck.v << " ck.w=" << ck.w << " ur=" << ur << " vr=" << vr << " wr=" << wr << " Hr=" << Hr << "\n";
+	    if(politique_anomalie==anomalie_lax_friedrichs){
+	      c.Flux_Lax_Friedrichs(ck,c.fluxk,sigma);
+	      continue;
+	    }
+	  }
 									
 	  //Speed of sound 
 	  double cr = sqrt(cr2); 
@@ -2808,8 +2859,7 @@ void Grille::fnumz(const double sigma, double t){
       for(int j=0;j<Ny+2*marge;j++){
 	Cellule& c = grille[i][j][k];
 	if(c.p<eps || c.rho<eps){
-	  cout << "p or rho negative: p " << c.p << " rho " << c.rho;
-	  getchar();
+	  anomalies.Signale(anomalie_pression_densite,t) << "i=" << i << " j=" << j << " k=" << k << " p=" << c.p << " rho=" << c.rho << "\n";
 	}
 	double cr = sqrt(gam*c.p/c.rho);
 	Cellule& cg = grille[i][j][k-1];
@@ -2885,8 +2935,7 @@ void Grille::fnumz(const double sigma, double t){
       for(int j=0;j<Ny+2*marge;j++){
 	Cellule& c = grille[i][j][k];
 	if(c.p<eps || c.rho<eps){
-	  cout << "p or rho negative: p " << c.p << " rho " << c.rho;
-	  getchar();
+	  anomalies.Signale(anomalie_pression_densite,t) << "i=" << i << " j=" << j << " k=" << k << " p=" << c.p << " rho=" << c.rho << "\n";
 	}
 	Cellule& cd = grille[i][j][k+1];
 	Cellule& cd2 = grille[i][j][k+2];
@@ -3307,136 +3356,200 @@ void Grille::BC(){
    \return void
 */
 void Grille::Impression(int n){
+  Instantane_fluide I;
+  Instantane(I,n);
+  Ecrit_instantane(I);
+}
+
+/*!\brief Copy of the fields written in the output files (see \a Ecrit_instantane(const Instantane_fluide&)).
+   \param I copy of the fields
+   \param n index of the output file
+   \return void
+*/
+void Grille::Instantane(Instantane_fluide& I, const int n){
+  I.n = n;
+  I.dx = dx;
+  I.dy = dy;
+  I.dz = dz;
+  double Cellule::* const champs[6] = {&Cellule::p, &Cellule::rho, &Cellule::u, &Cellule::v, &Cellule::w, &Cellule::alpha};
+  for(int m=0; m<6; m++){
+    I.champs[m].resize(Nx*Ny*Nz);
+#pragma omp parallel for schedule(static)
+    for(int i=marge; i<Nx+marge; i++){
+      int l = (i-marge)*Ny*Nz;
+      for(int j=marge; j<Ny+marge; j++){ 
+	for(int k=marge; k<Nz+marge; k++){
+	  I.champs[m][l++] = grille[i][j][k].*champs[m];
+	}
+      }
+    }
+  }
+}
+
+/*!\brief Output of the fluid fields in file fluide<n>.vtk.
+   \details Depending on \a sortie_structuree, the whole Cartesian grid (STRUCTURED_POINTS, with field alpha) or the fluid cells only (UNSTRUCTURED_GRID) are written, in binary or in ASCII depending on \a sortie_binaire. Only \a I is used, so that the writing can be done by \a Ecriture_asynchrone while the computation goes on.
+   \param I copy of the fields
+   \return void
+*/
+void Ecrit_instantane(const Instantane_fluide& I){
   //Output of the vtk file
   std::ostringstream oss;
-  oss << "resultats/fluide" << n << ".vtk";
+  oss << "resultats/fluide" << I.n << ".vtk";
   string s = oss.str();
   const char* const fluidevtk = s.c_str();
     
   //Open the output flux
-  std::ofstream vtk(fluidevtk,ios::out);
+  std::ofstream vtk(fluidevtk,ios::out|ios::binary);
   if(!vtk){
-    cout <<"Opening of fluide" << n << ".vtk failed" << endl;
+    cout <<"Opening of fluide" << I.n << ".vtk failed" << endl;
   }
   //Initialization of the vtk file
-  vtk << "# vtk DataFile Version 3.0" << endl;
-  vtk << "#Simulation Euler" << endl;
-  vtk << "ASCII" << endl;
+  vtk << "# vtk DataFile Version 3.0" << "\n";
+  vtk << "#Simulation Euler" << "\n";
+  vtk << (sortie_binaire ? "BINARY" : "ASCII") << "\n";
   vtk<<"\n";
-  vtk << "DATASET UNSTRUCTURED_GRID" << endl;
-  vtk << "POINTS " << (Nx+1)*(Ny+1) *(Nz+1)<< " DOUBLE" << endl;
+  //Pressure, density, velocity components and solid occupancy ratio
+  const char* noms[6] = {"pressure", "density", "u", "v", "w", "alpha"};
+  const std::vector<double>& alpha = I.champs[5];
+  
+  if(sortie_structuree){
+    //Uniform Cartesian grid: all the cells are written (x-index first), with the solid occupancy ratio
+    vtk << "DATASET STRUCTURED_POINTS" << "\n";
+    vtk << "DIMENSIONS " << Nx+1 << " " << Ny+1 << " " << Nz+1 << "\n";
+    vtk << "ORIGIN 0 0 0" << "\n";
+    vtk << std::setprecision(15) << "SPACING " << I.dx << " " << I.dy << " " << I.dz << std::setprecision(6) << "\n";
+    vtk << "CELL_DATA " << Nx*Ny*Nz << "\n";
+    std::vector<double> valeurs(Nx*Ny*Nz);
+    for(int m=0; m<6; m++){
+      vtk << "SCALARS " << noms[m] << " double 1" << "\n";
+      vtk << "LOOKUP_TABLE default" << "\n";
+      int l = 0;
+      for(int k=0; k<Nz; k++){
+	for(int j=0; j<Ny; j++){ 
+	  for(int i=0; i<Nx; i++){
+	    valeurs[l++] = I.champs[m][k+Nz*(j+Ny*i)];
+	  }
+	}
+      }
+      Ecrit_tableau_vtk(vtk, valeurs, 1, sortie_binaire);
+    }
+    return;
+  }
+  
+  vtk << "DATASET UNSTRUCTURED_GRID" << "\n";
+  vtk << "POINTS " << (Nx+1)*(Ny+1) *(Nz+1)<< " DOUBLE" << "\n";
     
+  std::vector<double> points(3*(Nx+1)*(Ny+1)*(Nz+1));
+  int l = 0;
   for(int i=0; i<Nx+1; i++){
     for(int j=0; j<Ny+1; j++){ 
       for(int k=0; k<Nz+1; k++){ 
-	vtk << i*dx << " " << j*dy << " " <<k*dz << " "<< endl;
+	points[l++] = i*I.dx;
+	points[l++] = j*I.dy;
+	points[l++] = k*I.dz;
       }
     }
   }
-  vtk<<"\n";
-
-  //Computation of the number of true fluid cells
-  int Nfluides = 0;
-  for(int i=marge; i<Nx+marge; i++){
-    for(int j=marge; j<Ny+marge; j++){ 
-      for(int k=marge; k<Nz+marge; k++){
-	Cellule& c = grille[i][j][k]; 
-	if(abs(c.alpha-1.)>eps){
-	  Nfluides++;
+  Ecrit_tableau_vtk(vtk, points, 3, sortie_binaire);
+
+  //List of the true fluid cells
+  std::vector<int> fluides;
+  std::vector<int> cellules;
+  for(int i=0; i<Nx; i++){
+    for(int j=0; j<Ny; j++){ 
+      for(int k=0; k<Nz; k++){
+	const int q = k+Nz*(j+Ny*i);
+	if(abs(alpha[q]-1.)>eps){
+	  fluides.push_back(q);
+	  const int p0 = k+j*(Nz+1)+i*(Nz+1)*(Ny+1);
+	  cellules.push_back(8);
+	  cellules.push_back(p0);
+	  cellules.push_back(p0+1);
+	  cellules.push_back(p0+1+(Nz+1));
+	  cellules.push_back(p0+(Nz+1));
+	  cellules.push_back(p0+(Nz+1)*(Ny+1));
+	  cellules.push_back(p0+1+(Nz+1)*(Ny+1));
+	  cellules.push_back(p0+1+(Nz+1)+(Nz+1)*(Ny+1));
+	  cellules.push_back(p0+(Nz+1)+(Nz+1)*(Ny+1));
 	}
       }
     }
   }
+  const int Nfluides = fluides.size();
 	
-  vtk << "CELLS " << Nfluides << " " << 9*Nfluides<< endl;
-    
-  for(int i=marge; i<Nx+marge; i++){
-    for(int j=marge; j<Ny+marge; j++){ 
-      for(int k=marge; k<Nz+marge; k++){
-	Cellule& c = grille[i][j][k]; 
-	if(abs(c.alpha-1.)>eps){
-	  vtk << 8 << " " << (k-marge)+(j-marge)*(Nz+1)+(i-marge)*(Nz+1)*(Ny+1) << " " << ((k-marge)+1)+(j-marge)*(Nz+1)+(i-marge)*(Nz+1)*(Ny+1) << " " << ((k-marge)+1)+((j-marge)+1)*(Nz+1) + (i-marge)*(Nz+1)*(Ny+1) << " "<< (k-marge)+((j-marge)+1)*(Nz+1) + (i-marge)*(Nz+1)*(Ny+1)<< " " <<  (k-marge)+(j-marge)*(Nz+1)+((i-marge)+1)*(Nz+1)*(Ny+1)<< " "<< ((k-marge)+1)+(j-marge)*(Nz+1) + ((i-marge)+1)*(Nz+1)*(Ny+1) << " " <<  ((k-marge)+1)+((j-marge)+1)*(Nz+1)+((i-marge)+1)*(Nz+1)*(Ny+1)<< " " << (k-marge)+((j-marge)+1)*(Nz+1)+((i-marge)+1)*(Nz+1)*(Ny+1)<< endl;
-	}
-      }
+  vtk << "CELLS " << Nfluides << " " << 9*Nfluides<< "\n";
+  Ecrit_tableau_vtk(vtk, cellules, 9, sortie_binaire);
+  vtk << "CELL_TYPES " <<Nfluides<<"\n";
+  std::vector<int> types(Nfluides,12);
+  Ecrit_tableau_vtk(vtk, types, 1, sortie_binaire);
+    
+  vtk << "CELL_DATA " << Nfluides << "\n";
+  std::vector<double> valeurs(Nfluides);
+  for(int m=0; m<5; m++){
+    vtk << "SCALARS " << noms[m] << " double 1" << "\n";
+    vtk << "LOOKUP_TABLE default" << "\n";
+    for(int l=0; l<Nfluides; l++){
+      valeurs[l] = I.champs[m][fluides[l]];
     }
+    Ecrit_tableau_vtk(vtk, valeurs, 1, sortie_binaire);
   }
-  vtk<<"\n";
-  vtk << "CELL_TYPES " <<Nfluides<<endl;
-  for(int k=0; k<Nfluides; k++){ 
-    vtk<<12<<endl;
-  }
-    
-  vtk<<"\n";
-  vtk << "CELL_DATA " << Nfluides << endl;
-  //Pressure
-  vtk << "SCALARS pressure double 1" << endl;
-  vtk << "LOOKUP_TABLE default" << endl;
-  for(int i=marge; i<Nx+marge; i++){
-    for(int j=marge; j<Ny+marge; j++){ 
-      for(int k=marge; k<Nz+marge; k++){ 
-	Cellule& c = grille[i][j][k]; 
-	if(abs(c.alpha-1.)>eps){ 
-	  vtk << grille[i][j][k].p << endl;
-	} 				
-      }
-    }
+}
+
+/*!\brief Allocation of the accumulators, starting at time \a t.
+   \param t time of the beginning of the accumulation
+   \param dx0 spatial discretization step in the x direction
+   \param dy0 spatial discretization step in the y direction
+   \param dz0 spatial discretization step in the z direction
+   \return void
+*/
+void Cumuls_fluide::Init(const double t, const double dx0, const double dy0, const double dz0){
+  debut = t;
+  duree = 0.;
+  dx = dx0; dy = dy0; dz = dz0;
+  for(int q=0; q<4; q++){
+    integrale[q].assign(Nx*Ny*Nz,0.);
+    maximum[q].assign(Nx*Ny*Nz,-std::numeric_limits<double>::max());
+    minimum[q].assign(Nx*Ny*Nz,std::numeric_limits<double>::max());
   }
-    
-  vtk<<"\n";
-  //Density
-  vtk << "SCALARS density double 1" << endl;
-  vtk << "LOOKUP_TABLE default" << endl;
-  for(int i=marge; i<Nx+marge; i++){
-    for(int j=marge; j<Ny+marge; j++){ 
-      for(int k=marge; k<Nz+marge; k++){ 
-	Cellule& c = grille[i][j][k]; 
-	if(abs(c.alpha-1.)>eps){ 
-	  vtk << grille[i][j][k].rho << endl;
+}
+
+/*!\brief Output of the pressure accumulators in file resultats/cumuls.vtk.
+   \details Whole Cartesian grid (STRUCTURED_POINTS, same frame as fluide*.vtk), in binary or in ASCII depending on \a sortie_binaire. For p, pdtx, pdty and pdtz: mean over the accumulation (time-integral divided by its time span), maximum, minimum and time-integral.
+   \param C accumulators
+   \return void
+*/
+void Ecrit_cumuls(const Cumuls_fluide& C){
+  std::ofstream vtk("resultats/cumuls.vtk",ios::out|ios::binary);
+  if(!vtk){
+    cout <<"Opening of cumuls.vtk failed" << endl;
+    return;
+  }
+  vtk << "# vtk DataFile Version 3.0" << "\n";
+  vtk << std::setprecision(15) << "#Accumulation from t=" << C.debut << " during " << C.duree << "\n";
+  vtk << (sortie_binaire ? "BINARY" : "ASCII") << "\n";
+  vtk << "DATASET STRUCTURED_POINTS" << "\n";
+  vtk << "DIMENSIONS " << Nx+1 << " " << Ny+1 << " " << Nz+1 << "\n";
+  vtk << "ORIGIN 0 0 0" << "\n";
+  vtk << "SPACING " << C.dx << " " << C.dy << " " << C.dz << std::setprecision(6) << "\n";
+  vtk << "CELL_DATA " << Nx*Ny*Nz << "\n";
+  const char* grandeurs[4] = {"p", "pdtx", "pdty", "pdtz"};
+  const char* statistiques[4] = {"moyenne", "max", "min", "integrale"};
+  std::vector<double> valeurs(Nx*Ny*Nz);
+  for(int q=0; q<4; q++){
+    const std::vector<double>* tableaux[4] = {&C.integrale[q], &C.maximum[q], &C.minimum[q], &C.integrale[q]};
+    for(int m=0; m<4; m++){
+      const double facteur = (m==0) ? ((C.duree>0.) ? 1./C.duree : 0.) : 1.;
+      int l = 0;
+      for(int k=0; k<Nz; k++){
+	for(int j=0; j<Ny; j++){ 
+	  for(int i=0; i<Nx; i++){
+	    valeurs[l++] = facteur*(*tableaux[m])[k+Nz*(j+Ny*i)];
+	  }
 	}
       }
-    }
-  }
-    
-  vtk<<"\n";
-  //Velocity x-component u
-  vtk << "SCALARS u double 1" << endl;
-  vtk << "LOOKUP_TABLE default" << endl;
-  for(int i=marge; i<Nx+marge; i++){
-    for(int j=marge; j<Ny+marge; j++){ 
-      for(int k=marge; k<Nz+marge; k++){ 
-	Cellule& c = grille[i][j][k]; 
-	if(abs(c.alpha-1.)>eps){ 
-	  vtk << grille[i][j][k].u << endl;
-	} 
-      }
-    }
-  }
-  vtk<<"\n";
-  //Velocity y-component v
-  vtk << "SCALARS v double 1" << endl;
-  vtk << "LOOKUP_TABLE default" << endl;
-  for(int i=marge; i<Nx+marge; i++){
-    for(int j=marge; j<Ny+marge; j++){ 
-      for(int k=marge; k<Nz+marge; k++){ 
-	Cellule& c = grille[i][j][k]; 
-	if(abs(c.alpha-1.)>eps){ 
-	  vtk << grille[i][j][k].v << endl;
-	}       
-      }
-    }
-  }
-  vtk<<"\n";
-  //Velocity z-component w
-  vtk << "SCALARS w double 1" << endl;
-  vtk << "LOOKUP_TABLE default" << endl;
-  for(int i=marge; i<Nx+marge; i++){
-    for(int j=marge; j<Ny+marge; j++){ 
-      for(int k=marge; k<Nz+marge; k++){ 
-	Cellule& c = grille[i][j][k]; 
-	if(abs(c.alpha-1.)>eps){ 
-	  vtk << grille[i][j][k].w << endl;
-	}       
-      }
+      vtk << "SCALARS " << grandeurs[q] << "_" << statistiques[m] << " double 1" << "\n";
+      vtk << "LOOKUP_TABLE default" << "\n";
+      Ecrit_tableau_vtk(vtk, valeurs, 1, sortie_binaire);
     }
   }
 }
@@ -27,11 +27,15 @@
 #include <cstdlib>
 #include <iostream>
 #include <vector>
+#include <map>
 #include <fstream>
 #include <stdio.h>
 #include <sstream>
 #include <cassert>
 #include "parametres.hpp"
+#include "journal.hpp"
+#include "anomalies.hpp"
+#include "sorties.hpp"
 #include "solide.hpp"
 
 
@@ -59,6 +63,8 @@ public :
   bool is_in_cell(double x,double y, double z);
 
   void Affiche ();  
+
+  void Flux_Lax_Friedrichs(const Cellule& cv, double* flux, const double sigma);
 	
   //!\brief (x,y,z) Position of the center of the cell.   
   double x;       
@@ -319,6 +325,58 @@ public :
   
 };
 
+/*! \brief Contribution of an interface face to one fluid cell (swept quantity and boundary flux).
+  \warning <b> Specific coupling class ! </b>
+ */
+struct Swap_contribution
+{
+  int i, j, k;         //!< Indices of the fluid cell.
+  double delta_w[5];   //!< Contribution to \a Cellule.delta_w.
+  double phi_x;        //!< Contribution to \a Cellule.phi_x.
+  double phi_y;        //!< Contribution to \a Cellule.phi_y.
+  double phi_z;        //!< Contribution to \a Cellule.phi_z.
+  double phi_v;        //!< Contribution to \a Cellule.phi_v.
+};
+
+/*! \brief Sparse accumulator of the contributions of one solid face to the fluid cells.
+  \details Filled by \a Grille.swap_face and \a Grille.swap_face_inexact instead of writing directly in \a Grille.grille, so that the faces can be processed concurrently in \a Grille.Swap_2d (with -DCELIA3D_SWAP_PARALLELE). The accumulators are then added to the grid in the serial order of the faces.
+  \warning <b> Specific coupling class ! </b>
+ */
+class Swap_accumulateur
+{
+ public:
+  Swap_accumulateur();
+  Swap_contribution& cellule(const int i, const int j, const int k);
+
+  std::vector<Swap_contribution> contributions; //!< Contributions, in the order of first access.
+  std::map<int,int> index;                      //!< Linear index of the cell -> position in \a contributions.
+  double volume_test;                           //!< Swept volume (conservation check).
+};
+
+/*! \brief Copy of the fluid fields written in an output file (see \a Grille.Instantane).
+  \details The fields are stored on the cells without the margins, index k+Nz*(j+Ny*i).
+ */
+struct Instantane_fluide
+{
+  int n;                         //!< Index of the output file.
+  double dx, dy, dz;             //!< Spatial discretization steps.
+  std::vector<double> champs[6]; //!< Pressure, density, velocity components and solid occupancy ratio.
+};
+
+/*! \brief Accumulators of the pressure in each cell over the time-steps (see \a Grille.Bilan_fluide).
+  \details For the pressure p at the end of the time-step and the effective pressures pdtx/dt, pdty/dt, pdtz/dt of the time-step: time-integral, maximum and minimum, on the cells without the margins, index k+Nz*(j+Ny*i).
+ */
+struct Cumuls_fluide
+{
+  void Init(const double t, const double dx0, const double dy0, const double dz0);
+  double debut;                       //!< Time of the beginning of the accumulation.
+  double duree;                       //!< Time span of the accumulation.
+  double dx, dy, dz;                  //!< Spatial discretization steps.
+  std::vector<double> integrale[4];   //!< Time-integrals of p, pdtx/dt, pdty/dt and pdtz/dt (impulses).
+  std::vector<double> maximum[4];     //!< Maxima of p, pdtx/dt, pdty/dt and pdtz/dt.
+  std::vector<double> minimum[4];     //!< Minima of p, pdtx/dt, pdty/dt and pdtz/dt.
+};
+
 //! Definition of class Grille
 class Grille
 {
@@ -348,8 +406,10 @@ class Grille
   double Impulsiony();
   double Impulsionz();
   double Energie();
+  void Bilan_fluide(double& m, double& impx, double& impy, double& impz, double& E, Cumuls_fluide* cumuls, const double dt);
  
   void Impression(int n);
+  void Instantane(Instantane_fluide& I, const int n);
   
   void solve_fluidx(const double dt);
   void solve_fluidy(const double dt);
@@ -369,8 +429,8 @@ class Grille
   void Modif_fnum(const double dt);  
   void Mixage(); 
   void Fill_cel(Solide& S);
-  void swap_face(const Triangles& T3d_prev, const Triangles& T3d_n, const double dt,  Particule & P, double & volume_test);
-  void swap_face_inexact(const Triangle_3& Tr_prev, const Triangle_3& Tr, const Triangles& T3d_prev, const Triangles& T3d_n, const double dt,  Particule & P, double & volume_test);
+  void swap_face(const Triangles& T3d_prev, const Triangles& T3d_n, const double dt,  Particule & P, Swap_accumulateur& acc);
+  void swap_face_inexact(const Triangle_3& Tr_prev, const Triangle_3& Tr, const Triangles& T3d_prev, const Triangles& T3d_n, const double dt,  Particule & P, Swap_accumulateur& acc);
   void cells_intersection_face(int& in,int& jn,int& kn,int& in1,int& jn1,int& kn1, std::vector<Bbox>& box_cells, std::vector<Cellule>& Cells);
   void Swap_2d(const double dt, Solide& S);
   void Swap_3d(const double dt, Solide& S); 
@@ -395,4 +455,25 @@ class Grille
 
 };
 
+void Ecrit_instantane(const Instantane_fluide& I);
+void Ecrit_cumuls(const Cumuls_fluide& C);
+
+/*! \brief Global balances of the fluid and of the solid.
+  \details Computed once per time-step by \a Bilan.Calcul: one parallel pass on the fluid grid (\a Grille.Bilan_fluide), which also updates the pressure accumulators if any, and one on the solid, with compensated summation.
+ */
+class Bilan
+{
+ public:
+  Bilan();
+  void Calcul(Grille& Fluide, Solide& S, Cumuls_fluide* cumuls=NULL, const double dt=0.);
+  double Energie() const { return energie_fluide+energie_cinetique+energie_potentielle; } //!< Total energy
+  double Energie_solide() const { return energie_cinetique+energie_potentielle; } //!< Solid energy
+
+  double masse;               //!< Fluid mass
+  double impx, impy, impz;    //!< Fluid momentum
+  double energie_fluide;      //!< Fluid total energy
+  double energie_cinetique;   //!< Solid kinetic energy
+  double energie_potentielle; //!< Solid potential energy
+};
+
 #endif
@@ -412,6 +412,50 @@ double intersect_cube_tetrahedron_bis(const Bbox& cube, const Tetrahedron& Tet,
 
 
 
+/*!\brief Angular order of coplanar 3d points around a point \a g, counterclockwise with regards to normal \a N.
+   \details Exact comparison using function <b> CGAL::orientation(Vector_3, Vector_3, Vector_3)</b>: the points are first split into two half-planes delimited by the reference direction \a r, then sorted counterclockwise in each half-plane.
+*/
+struct Ordre_angulaire_3d
+{
+  Point_3 g;  //!< Center of the angular order
+  Vector_3 r; //!< Reference direction in the plane
+  Vector_3 N; //!< Normal to the plane
+  Ordre_angulaire_3d(const Point_3& g0, const Vector_3& r0, const Vector_3& N0): g(g0), r(r0), N(N0) {}
+  int demi_plan(const Vector_3& v) const {
+    const CGAL::Orientation o = CGAL::orientation(r, v, N);
+    return ((o == CGAL::POSITIVE) || ((o == CGAL::COLLINEAR) && (v*r > 0))) ? 0 : 1;
+  }
+  bool operator()(const Point_3& a, const Point_3& b) const {
+    const Vector_3 va(g, a), vb(g, b);
+    const int da = demi_plan(va), db = demi_plan(vb);
+    if(da != db){ return da < db; }
+    return CGAL::orientation(va, vb, N) == CGAL::POSITIVE;
+  }
+};
+
+/*!\brief Triangulation of a planar convex polygon, oriented by the exterior normal \a N.
+   \details The vertices (in any order, possibly repeated) are sorted counterclockwise with regards to \a N around their centroid (\a Ordre_angulaire_3d), and the polygon is split into a fan of triangles from its first vertex, so that the normal of each triangle has the direction of \a N. Triangles of area smaller than \a eps are discarded.
+   \param vPoints vertices of the polygon (sorted by the function)
+   \param N exterior normal to the polygon
+   \param tri Triangles: the triangles are appended to \a tri
+   \warning <b> Specific coupling procedure ! </b>
+   \return void
+*/
+void triangulation_polygone_convexe_3d(std::vector<Point_3>& vPoints, const Vector_3& N, Triangles& tri){
+  if(vPoints.size() < 3){ return; }
+  const Point_3 g = CGAL::centroid(vPoints.begin(), vPoints.end());
+  int l0 = 0;
+  while(l0<vPoints.size() && vPoints[l0]==g){ l0++; }
+  if(l0==vPoints.size()){ return; }
+  std::sort(vPoints.begin(), vPoints.end(), Ordre_angulaire_3d(g, Vector_3(g, vPoints[l0]), N));
+  for(int l=1; l+1<vPoints.size(); l++){
+    const Triangle_3 Tri(vPoints[0], vPoints[l], vPoints[l+1]);
+    if(std::sqrt(CGAL::to_double(Tri.squared_area())) >eps){
+      tri.push_back(Tri);
+    }
+  }
+}
+
 /*!\brief Intersection of the fluid grid with solid.
   \details Intersection of the fluid grid with the solid and computation of the quantities of interest: solid occupancy ratio in the cell (\a Cellule.alpha), solid occupancy ratio on the cell faces (\a Cellule.kappai, \a Cellule.kappaj and \a Cellule.kappak). Definition of the interface objects: \n
   - \a Particule.Points_interface: intersection points of the cell with the triangular faces of the solid; \n
@@ -442,7 +486,7 @@ double intersect_cube_tetrahedron_bis(const Bbox& cube, const Tetrahedron& Tet,
   \remark The vector \a Particule.Points_interface containing the intersection points between fluid cells and triangular faces (\a Particule.triangles) is progressively filled during the intersection algorithm. \n
   The intersection result is used  to compute the interest quantities \a Cellule.alpha, \a Cellule.kappai, \a Cellule.kappaj and \a Cellule.kappak. \n
   The function used in the intersection computation are
-  <b> CGAL::Triangulation(vector<Point_3>) </b>, <b> CGAL::convex_hull_3(vector<Point_3>, Polyhedron_3) </b>, <b> CGAL::tetrahedron.volume() </b> and <b> CGAL::Triangle_3.squared_area()</b>. \n
+  triangulation_polygone_convexe_3d(std::vector<Point_3>&, const Vector_3&, Triangles&), <b> CGAL::convex_hull_3(vector<Point_3>, Polyhedron_3) </b>, <b> CGAL::tetrahedron.volume() </b> and <b> CGAL::Triangle_3.squared_area()</b>. \n
   *\param S Solide
   *\param dt Time-step
   *\warning <b> Specific coupling procedure ! </b>
@@ -502,13 +546,15 @@ void Grille::Parois_particles(Solide& S,double dt) {
 	
   int nb_particules = S.size();
   int taille = box_grille.size();
-  cout<<"the grille size is : "<<taille<<endl;
-  cout<<"Number of particles: "<<nb_particules<<endl;
-  int nb_triangles=0.;
-  for(int iter=0; iter<nb_particules; iter++){
-    nb_triangles += S.solide[iter].triangles.size();
+  if(journal.actif(journal_intersections,journal_detail)){
+    journal.flux()<<"the grille size is : "<<taille<<"\n";
+    journal.flux()<<"Number of particles: "<<nb_particules<<"\n";
+    int nb_triangles=0.;
+    for(int iter=0; iter<nb_particules; iter++){
+      nb_triangles += S.solide[iter].triangles.size();
+    }
+    journal.flux()<<"Number of triangles: "<<nb_triangles<<"\n";
   }
-  cout<<"Number of triangles: "<<nb_triangles<<endl;
 
   vertices_time.reset();
   const double eps_box = 0.1;
@@ -838,33 +884,20 @@ void Grille::Parois_particles(Solide& S,double dt) {
 				
 	//Triangulation of the interface face by face
 	triangularisation_time.reset();
-	ExactFinite_faces_iterator iter;
+	Triangles Tri_poly;
 	for(int count=0; count<nb_particules;count++){
 	  for(int it=0; it<S.solide[count].triangles.size(); it++){ 
 			
 				    
 	    if(Points_interface[count][it].size()>2){ 
 	      triangulation_time2.reset();
-	      ExactTriangulation T(Points_interface[count][it].begin(), Points_interface[count][it].end());
+	      Tri_poly.clear();
+	      triangulation_polygone_convexe_3d(Points_interface[count][it], S.solide[count].normales[it], Tri_poly);
 	      temps_triangulation2 += triangulation_time2.time();
-	      assert(T.is_valid());
-	      if(T.dimension()==2){
-		for (iter = T.finite_facets_begin(); iter != T.finite_facets_end(); iter++){
-		  Triangle_3 Tri= T.triangle(*iter);
-		  if(std::sqrt(CGAL::to_double(Tri.squared_area())) >eps){
-		    Vector_3 vect0(Tri.operator[](0),Tri.operator[](1));
-		    Vector_3 vect1(Tri.operator[](0),Tri.operator[](2));
-		    Vector_3 normale = CGAL::cross_product(vect0,vect1);
-		    if (normale*S.solide[count].normales[it] > 0.){
-		      S.solide[count].Triangles_interface[it].push_back(Tri);
-		    }
-		    else {
-		      S.solide[count].Triangles_interface[it].push_back(Triangle_3(Tri.operator[](0),Tri.operator[](2),Tri.operator[](1)));
-		    }
-		    std::vector<int> poz(3); poz[0]= a; poz[1] = b; poz[2] = c;
-		    S.solide[count].Position_Triangles_interface[it].push_back(poz);
-		  }
-		}
+	      for(int l=0; l<Tri_poly.size(); l++){
+		S.solide[count].Triangles_interface[it].push_back(Tri_poly[l]);
+		std::vector<int> poz(3); poz[0]= a; poz[1] = b; poz[2] = c;
+		S.solide[count].Position_Triangles_interface[it].push_back(poz);
 	      }
 	    }
 	  } 
@@ -875,33 +908,35 @@ void Grille::Parois_particles(Solide& S,double dt) {
     }
   }	
   user_time.reset();
-  cout<<"volume solide parois := "<<volume_s<<endl;
+  JOURNAL(journal_intersections,journal_diagnostic)<<"volume solide parois := "<<volume_s<<"\n";
   temps_total = CGAL::to_double(total_time.time());
 	
-  cout << "######### COUTS INTERSECTIONS ##########" << endl;
-  cout << "Bbox=" << 100*temps_bbox/temps_total << "%" << endl;
-  cout << "tri vertices=" << 100*temps_vertices/temps_total << "%" << endl;
-  cout << "do_intersect=" << 100*temps_do_intersect/temps_total << "%" << endl;
-  cout << "   test intersect=" << 100*temps_test/temps_total << "%" << endl;
-  cout << "   test_inside=" << 100*temps_test_inside/temps_total << "%" << endl;
-  cout << "   coin=" << 100*temps_coin/temps_total << "%" << endl;
-  cout << "   sommet=" << 100*temps_sommet/temps_total << "%          t_moy=" << temps_sommet/nb_sommet << " nb_sommet=" << nb_sommet << endl;
-  cout << "   sommet_interface=" << 100*temps_sommet_interface/temps_total << "%          t_moy=" << temps_sommet_interface/nb_sommet_interface << " nb_sommet_interface=" << nb_sommet_interface << endl;
-  cout << "      test_sommet_interface=" << 100*temps_test_sommet_interface/temps_total << "%" << endl;
-  cout << "      push_back=" << 100*temps_push_back/temps_total << "%" << endl;
-  cout << "   aretes_cellule=" << 100*temps_aretes_cellule/temps_total << "%" << endl;
-  cout << "   aretes_solide=" << 100*temps_aretes_solide/temps_total << "%" << endl;
-  cout << "      intersect=" << 100*temps_intersect/temps_total << "%          t_moy=" << temps_intersect/nb_intersect << " nb_intersect=" << nb_intersect << endl;
-  cout << "   alpha=" << 100*temps_alpha/temps_total << "%" << endl;
-  cout << "      triangulation=" << 100*temps_triangulation/temps_total << "%          t_moy=" << temps_triangulation/nb_convex_hull << " nb_triangulation=" << nb_convex_hull << endl;
-  cout << "      convex_hull=" << 100*temps_convex_hull/temps_total << "%          t_moy=" << temps_convex_hull/nb_convex_hull << " nb_convex_hull=" << nb_convex_hull << endl;
-  cout << "      volume=" << 100*temps_volume/temps_total << "%" << endl;
-  cout << "      kappa 3d=" << 100*temps_kappa1/temps_total << "%          t_moy=" << temps_kappa1/nb_kappa1 << " nb_kappa1=" << nb_kappa1 << endl;
-  cout << "      kappa 2d=" << 100*temps_kappa2/temps_total << "%          t_moy=" << temps_kappa2/nb_kappa2 << " nb_kappa2=" << nb_kappa2 << endl;
-  cout << "triangularisation=" << 100*temps_triangularisation/temps_total << "%" << endl;
-  cout << "   triangulation=" << 100*temps_triangulation2/temps_total << "%" << endl;
-  cout << "Reste=" << 100-100*(temps_bbox+temps_vertices+temps_do_intersect+temps_triangularisation)/temps_total << "%" << endl;
-  cout << "########################################" << endl;
+  if(journal.actif(journal_couts,journal_detail)){
+    journal.flux() << "######### COUTS INTERSECTIONS ##########" << "\n";
+    journal.flux() << "Bbox=" << 100*temps_bbox/temps_total << "%" << "\n";
+    journal.flux() << "tri vertices=" << 100*temps_vertices/temps_total << "%" << "\n";
+    journal.flux() << "do_intersect=" << 100*temps_do_intersect/temps_total << "%" << "\n";
+    journal.flux() << "   test intersect=" << 100*temps_test/temps_total << "%" << "\n";
+    journal.flux() << "   test_inside=" << 100*temps_test_inside/temps_total << "%" << "\n";
+    journal.flux() << "   coin=" << 100*temps_coin/temps_total << "%" << "\n";
+    journal.flux() << "   sommet=" << 100*temps_sommet/temps_total << "%          t_moy=" << temps_sommet/nb_sommet << " nb_sommet=" << nb_sommet << "\n";
+    journal.flux() << "   sommet_interface=" << 100*temps_sommet_interface/temps_total << "%          t_moy=" << temps_sommet_interface/nb_sommet_interface << " nb_sommet_interface=" << nb_sommet_interface << "\n";
+    journal.flux() << "      test_sommet_interface=" << 100*temps_test_sommet_interface/temps_total << "%" << "\n";
+    journal.flux() << "      push_back=" << 100*temps_push_back/temps_total << "%" << "\n";
+    journal.flux() << "   aretes_cellule=" << 100*temps_aretes_cellule/temps_total << "%" << "\n";
+    journal.flux() << "   aretes_solide=" << 100*temps_aretes_solide/temps_total << "%" << "\n";
+    journal.flux() << "      intersect=" << 100*temps_intersect/temps_total << "%          t_moy=" << temps_intersect/nb_intersect << " nb_intersect=" << nb_intersect << "\n";
+    journal.flux() << "   alpha=" << 100*temps_alpha/temps_total << "%" << "\n";
+    journal.flux() << "      triangulation=" << 100*temps_triangulation/temps_total << "%          t_moy=" << temps_triangulation/nb_convex_hull << " nb_triangulation=" << nb_convex_hull << "\n";
+    journal.flux() << "      convex_hull=" << 100*temps_convex_hull/temps_total << "%          t_moy=" << temps_convex_hull/nb_convex_hull << " nb_convex_hull=" << nb_convex_hull << "\n";
+    journal.flux() << "      volume=" << 100*temps_volume/temps_total << "%" << "\n";
+    journal.flux() << "      kappa 3d=" << 100*temps_kappa1/temps_total << "%          t_moy=" << temps_kappa1/nb_kappa1 << " nb_kappa1=" << nb_kappa1 << "\n";
+    journal.flux() << "      kappa 2d=" << 100*temps_kappa2/temps_total << "%          t_moy=" << temps_kappa2/nb_kappa2 << " nb_kappa2=" << nb_kappa2 << "\n";
+    journal.flux() << "triangularisation=" << 100*temps_triangularisation/temps_total << "%" << "\n";
+    journal.flux() << "   triangulation=" << 100*temps_triangulation2/temps_total << "%" << "\n";
+    journal.flux() << "Reste=" << 100-100*(temps_bbox+temps_vertices+temps_do_intersect+temps_triangularisation)/temps_total << "%" << "\n";
+    journal.flux() << "########################################" << "\n";
+  }
 	
 }
 
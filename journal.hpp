@@ -0,0 +1,87 @@
+//Copyright 2017 Laurent Monasse
+
+/*
+  This file is part of CELIA3D.
+  
+  CELIA3D is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  CELIA3D is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  
+  You should have received a copy of the GNU General Public License
+  along with CELIA3D.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+   \file
+   \authors Laurent Monasse and Maria Adela Puscas
+   \brief Console output of the simulation, filtered by level and category.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <mutex>
+#include "parametres.hpp"
+
+#ifndef JOURNAL_HPP
+#define JOURNAL_HPP
+
+/*!\brief Console output of the simulation.
+
+The messages are filtered by level (\a niveau_journal) and by category (\a pas_journal gives the stride in time iterations of each category). They are accumulated in a buffer which is written to the console without flush at the end of each time iteration (\a Journal.Vide()). The errors of the writing thread (\a Journal.Erreur) are written whatever the level.
+*/
+class Journal
+{
+public:
+  Journal(): n(0) {}
+  
+  //! \brief Current time iteration
+  void Iteration(const int iter) { n = iter; }
+  
+  //! \brief True if a message of category \a categorie and level \a niveau must be written at the current time iteration
+  bool actif(const int categorie, const int niveau) const {
+    return niveau <= niveau_journal && pas_journal[categorie] > 0 && n%pas_journal[categorie] == 0;
+  }
+  
+  //! \brief Buffer of the messages
+  std::ostream& flux() { return tampon; }
+  
+  //! \brief Error message of the writing thread (\a Ecriture_asynchrone), written by the next \a Journal.Vide() whatever the level
+  void Erreur(const std::string& message) {
+    std::lock_guard<std::mutex> verrou(acces);
+    erreurs += message;
+  }
+  
+  //! \brief Writes the buffer to the console, without flush
+  void Vide() {
+    std::string s = tampon.str();
+    {
+      std::lock_guard<std::mutex> verrou(acces);
+      s += erreurs;
+      erreurs.clear();
+    }
+    if(!s.empty()){
+      std::cout.write(s.data(), s.size());
+      tampon.str(std::string());
+    }
+  }
+  
+private:
+  int n; //!< Current time iteration
+  std::ostringstream tampon; //!< Buffer of the messages
+  std::string erreurs; //!< Error messages of the writing thread
+  std::mutex acces; //!< Access to \a erreurs
+};
+
+Journal journal; //!< Console output of the simulation
+
+//! \brief Stream of the console output for a message of category \a categorie and level \a niveau. The arguments of the message are not evaluated if it is filtered.
+#define JOURNAL(categorie,niveau) if(!journal.actif(categorie,niveau)){} else journal.flux()
+
+#endif
@@ -30,15 +30,21 @@
   Using the software:
   - install <b> library CGAL-4.0 </b>
   - cgal_creat_cmake_script
-  - cmake .
+  - cmake -DCMAKE_CXX_FLAGS="-std=c++11 -pthread -fopenmp" . : the code requires C++11 and the threads library (background writer \a Ecriture_asynchrone); OpenMP is optional
   - make: compile
+  - without CMake: g++ -O3 -std=c++11 -pthread -fopenmp -frounding-math main.cpp -o main -lCGAL -lgmp -lmpfr
+  - optional parallel swap of the exact cut-cells (\a Grille.Swap_2d): compile with -DCELIA3D_SWAP_PARALLELE (requires a thread-safe CGAL lazy exact kernel)
   - ./main: execute 
+  - ./main resultats/reprise<n>.bin: restart from a binary checkpoint
+  - optional HDF5 outputs (\a sortie_hdf5): compile with -DCELIA3D_HDF5 and link with the HDF5 C library (-lhdf5)
  
   Parameters to be filled in before launching a simulation:
  
   - \a parametres.hpp: define the parameters of the problem; 
   - \a parametres.cpp: define the initial state of the fluid: density, pressure, velocity;
   - create file <b> "maillage.dat" </b> to define the solid mesh.\n
+  - optionally, create file <b> "sondes.dat" </b> to define probes in the fluid and sensors on the particles (see \a Sondes).\n
+  - optionally, create file <b> "coupes.dat" </b> to define slices and subsampled volumes of the fluid written more often than the full outputs (see \a Coupes).\n
  
  
  
@@ -85,10 +91,16 @@
  
  
   The results are written in directory \b resultats. Some files are updated at each time-step:
-  files energie.dat and temps_reprise.dat give respectively the evolution of energy and the simulation time.
+  files energie.dat and temps_reprise.dat give respectively the evolution of energy and the simulation time. They are kept in memory and written every \a pas_series time iterations, at the end, and when the computation is stopped by SIGINT or SIGTERM (the state is then written as at the end).
+  File series.csv (or series.bin and series.bin.txt, depending on \a format_series) gives at each time iteration the time-step, the energies, the mass variation, the numbers of sub-cycles and of semi-implicit iterations and the cpu time of each phase. \n
   Files fluide*.vtk and solide*.vtk are written a limited number of times in the span of the simulation. fluide*.vtk and solide*.vtk give respectively the state of the fluid and the position of the solid. They can be read using Paraview.
+  With \a sortie_hdf5, all the outputs are appended instead to the single file resultats.h5 (chunked and compressed datasets), opened in Paraview through resultats.xmf. \n
   File temps.dat gives the cpu cost at the end of the simulation. \n
+  File cumuls.vtk gives the mean, maximum, minimum and time-integral of the pressure in each cell if \a cumuls_fluide is true. \n
+  Files sondes.bin and sondes.txt give the time series of the probes of sondes.dat and the description of their columns. \n
+  File anomalies.dat records the anomalies detected during the computation (negative speed of sound, pressure or density); the action taken is set by \a politique_anomalie in file parametres.hpp. \n
   It is possible to restart interrupted simulations from recovery files fluide*.vtk and solide*.vtk. It suffices to change recovery flag bool rep = false to bool rep=true in file parametres.h and indicate the recovery point with int numrep.
+  If \a sauvegarde_reprise is true, a binary checkpoint reprise*.bin of the whole state (fluid, cut-cells, solid kinematics, broken links, energy baselines) is written with each output. The simulation restarts exactly from it with ./main resultats/reprise<n>.bin, with the same parameters and maillage.dat; energie.dat, temps_reprise.dat, ruptures.dat, series.* and sondes.bin are then continued, after removing the rows written by the interrupted run after the checkpoint.
  
  
   \remark Procedures dealing with the fluid are in files fluide.hpp and
@@ -110,12 +122,43 @@
 
 #include <iostream>
 #include <ctime>
+#include <csignal>
 #include "fluide.cpp"
 #include "solide.cpp" 
 #include "couplage.cpp"
 #include "parametres.cpp"
+#include "ecriture.hpp"
+#include "reprise.hpp"
+#include "sondes.hpp"
+#include "coupes.hpp"
+#include "series.hpp"
 using namespace std;          
 
+volatile std::sig_atomic_t signal_recu = 0; //!< Signal (SIGINT or SIGTERM) asking to stop the computation, 0 if none
+
+/*!\brief Records the signal \a s: the computation stops at the end of the time-step, after writing the time series and the state.
+ \details A second signal terminates the program immediately.
+ \param s signal
+ \return void
+ */
+extern "C" void Arret_signal(int s){
+  signal_recu = s;
+  std::signal(s,SIG_DFL);
+}
+
+/*!\brief Mass check after a phase of the time-step, every \a pas_controle_masse time iterations.
+ \param phase name of the phase
+ \param Fluide fluid grid
+ \param masse reference fluid mass
+ \param n time iteration
+ \return void
+ */
+void Controle_masse(const char* phase, Grille& Fluide, const double masse, const int n){
+  if(pas_controle_masse>0 && n%pas_controle_masse==0 && journal.actif(journal_bilan,journal_diagnostic)){
+    journal.flux() << phase << " Mass Variation : " << Fluide.Masse() - masse << "\n";
+  }
+}
+
 /*!\brief Initialization of the problem and resolution:
 
  - Initialization of the solid and the fluid using respectively functions \a Solide.Init(const char*) and \a Grille.Init().
@@ -123,7 +166,7 @@ using namespace std;
  - Resolution of the fluid equations using function \a Grille.Solve(const double, double, int).
  - Computation of internal forces using function \a Solide.Forces_internes().
  -  Computation of fluid forces (\a Particule.Ff) and torques (\a Particule.Mf) acting on the solid using function \a Grille.Forces_fluide(Solide&, const double).
- - Update of the position of the solid using function \a Solide.Solve_position(double).
+ - Update of the position of the solid using function \a Solide.Solve_position(double,int) (with \a n_sub_max > 1, the solid is sub-cycled within the fluid time-step).
  - Computation of the solid velocity using function \a Solide.Solve_vitesse(double).
  - Intersection of the fluid grid with the solid using function \a Grille.Parois(Solide&, double).
  - Computation of the fluid quantity swept by the solid using function \a Grille.Swap_2d(double, Solide&).
@@ -131,12 +174,21 @@ using namespace std;
  - Conservative mixing of small cut-cells using function \a Grille.Mixage().
  - Filling of ghost cells using function \a Grille.Fill_cel(Solide&).
  - Imposing boundary conditions using function \a Grille.BC().
+ - Computation of the global balances of the fluid and of the solid, once per time-step, using function \a Bilan.Calcul(Grille&, Solide&).
  
+ \param argc number of arguments
+ \param argv optional checkpoint file resultats/reprise<n>.bin to restart from (see \a Sauvegarde_reprise)
  \return int
  */
-int main(){
+int main(int argc, char* argv[]){
   char temps_it[]="resultats/temps.dat";
   char temps_reprise[]="resultats/temps_reprise.dat";
+  //Restart from a binary checkpoint: the state is read after the initialization
+  const bool reprise_binaire = (argc>1);
+  Etat_reprise etat_reprise;
+  if(reprise_binaire){
+    rep = false;
+  }
   //In case of recovery
   double temps[numrep+1];
   if(rep){
@@ -156,13 +208,13 @@ int main(){
   
   //Open output fluxes
   std::ofstream temps_iter(temps_it,ios::out);
-  std::ofstream sorties_reprise(temps_reprise,ios::out);
+  std::ofstream sorties_reprise(temps_reprise,reprise_binaire ? ios::app : ios::out);
   if(!temps_iter){
     cout <<"Opening of 'temps.dat' failed" << endl;
   }
   if(rep){
     for(int i=0;i<numrep+1;i++){
-      sorties_reprise << temps[i] << endl;
+      sorties_reprise << temps[i] << "\n";
     }
   }
   
@@ -170,18 +222,32 @@ int main(){
   char energie[]="resultats/energie.dat";
 	
 //Open output fluxes
-  std::ofstream ener(energie,ios::out);
-  if(!ener){
-    cout <<"Opening of  'energie.dat' failed" << endl;
+  const char* colonnes_energie[] = {"t", "E", "E_solide", "dE", "dE_solide", "dmasse"};
+  Series_temporelles ener(energie,series_texte,vector<string>(colonnes_energie,colonnes_energie+6),reprise_binaire);
+  const char* colonnes_series[] = {"t", "dt", "E", "E_solide", "dE", "dE_solide", "dmasse", "n_sub", "iterations_semi_implicite",
+				   "temps_flux", "temps_explicite", "temps_intersections", "temps_semi_implicite", "temps_forces_internes",
+				   "temps_vitesse", "temps_swap", "temps_modif_fnum", "temps_mixage", "temps_fill_cel", "temps_BC", "temps_total"};
+  const int nb_colonnes_series = sizeof(colonnes_series)/sizeof(colonnes_series[0]);
+  const char* noms_series[3] = {"resultats/series.dat", "resultats/series.csv", "resultats/series.bin"};
+  Series_temporelles series(noms_series[format_series],format_series,vector<string>(colonnes_series,colonnes_series+nb_colonnes_series),reprise_binaire);
+  //Broken links: time, link, particles, elongation
+  std::ofstream ruptures("resultats/ruptures.dat",reprise_binaire ? ios::app : ios::out);
+  if(!ruptures){
+    cout <<"Opening of 'ruptures.dat' failed" << endl;
   }
   double dE0rep,dE0Srep,dm0;
   if(rep){
     double t_ener = 0.;
-    double E,Es,dE,dEs,dm, tmp;
+    double E,Es,dE,dEs,dm;
+    //energie.dat: 6 columns (see colonnes_energie)
     for(int i=0;t_ener<temps[numrep];i++){
-      in_energie >>t_ener >> E >> Es >> dE >> dEs >> dm >> tmp;
+      in_energie >>t_ener >> E >> Es >> dE >> dEs >> dm;
+      if(!in_energie){
+	break;
+      }
       if(t_ener<=temps[numrep]){
-	ener << t_ener << " " << E << " " << Es << " " << dE << " " << dEs << " " << dm << 0 << endl;
+	const double ligne[6] = {t_ener, E, Es, dE, dEs, dm};
+	ener.Ajoute(ligne);
 	dE0rep = dE;
 	dE0Srep = dEs;
 	dm0 = dm;
@@ -199,41 +265,87 @@ int main(){
   S.Init("maillage.dat"); //Initialization of solid
   Grille Fluide;
   Fluide.Init();
-  Fluide.Parois_particles(S,dt);
+  Relaxation_Aitken Aitken;
+  Cumuls_fluide cumuls; //Pressure accumulators, updated in the balance pass
+  if(cumuls_fluide){
+    cumuls.Init(t,Fluide.dx,Fluide.dy,Fluide.dz);
+  }
+  if(reprise_binaire){
+    if(!Chargement_reprise(argv[1],Fluide,S,Aitken,etat_reprise,cumuls_fluide ? &cumuls : NULL)){
+      cout << "Restart from '" << argv[1] << "' failed, see resultats/anomalies.dat" << endl;
+      return EXIT_FAILURE;
+    }
+    t = etat_reprise.t;
+    //The rows written by the interrupted run after the checkpoint are removed
+    Tronque_serie(energie,t,false,false);
+    Tronque_serie(noms_series[format_series],t,true,format_series==series_binaire);
+    Tronque_serie(temps_reprise,t,true,false);
+    Tronque_serie("resultats/ruptures.dat",t,false,false);
+    Tronque_serie("resultats/sondes.bin",t,true,true);
+    Tronque_trajectoire("resultats/solide_trajectoire.bin",t);
+  } else {
+    Fluide.Parois_particles(S,dt);
+  }
   Fluide.BC();
 	
   double volume_initial= 0.;
 	
-  for (int count=0; count<S.size(); count++){
-    volume_initial +=S.solide[count].volume();
+  if(reprise_binaire){
+    volume_initial = etat_reprise.volume_initial;
+  } else {
+    for (int count=0; count<S.size(); count++){
+      volume_initial +=S.solide[count].volume();
+    }
   }
   	
+  Sondes sondes; //Time series of the probes, sampled at the end of the time-steps
+  sondes.Init("sondes.dat",Fluide,S,reprise_binaire);
+  if(!reprise_binaire){
+    sondes.Echantillonne(Fluide,S,0,t);
+  }
+  Coupes coupes; //Slices and subsampled volumes, each one with its own period
+  coupes.Init("coupes.dat",t);
+	
   int iter=0;	
+  const int iter_reprise = reprise_binaire ? etat_reprise.iteration : 0; //Time iterations before the restart, so that the probes keep their sampling
   clock_t start,end;
   start =clock();
 
   int kimp = 0; //Output index
   double next_timp = dtimp; //Next output time
-  if(rep){
-    kimp = numrep;
-    next_timp = t+dtimp;
+  //Output files written while the computation goes on; on a restart, the outputs after the checkpoint are removed from resultats.h5
+  Ecriture_asynchrone ecriture(reprise_binaire || rep, reprise_binaire ? etat_reprise.kimp : numrep+1);
+  if(reprise_binaire){
+    kimp = etat_reprise.kimp;
+    next_timp = etat_reprise.next_timp;
   } else {
-    Fluide.Impression(kimp);
-    S.Impression(kimp);
-    sorties_reprise << t << endl;
+    if(rep){
+      kimp = numrep;
+      next_timp = t+dtimp;
+    } else {
+      ecriture.Ajoute(Fluide,S,kimp,t);
+      sorties_reprise << t << "\n";
+    }
+    kimp++;
   }
-  kimp++;
 	
-  double E0 = Fluide.Energie()+S.Energie();
-  double E0S= S.Energie();
+  Bilan bilan; //Global balances, computed once per time-step
+  bilan.Calcul(Fluide,S);
+  double E0 = bilan.Energie();
+  double E0S= bilan.Energie_solide();
   if(rep){
     E0 -= dE0rep;
     E0S -= dE0Srep;
   }
-  double masse = Fluide.Masse();
+  double masse = bilan.masse;
   if(rep){
     masse -= dm0;
   }
+  if(reprise_binaire){
+    E0 = etat_reprise.E0;
+    E0S = etat_reprise.E0S;
+    masse = etat_reprise.masse;
+  }
   S.Forces_internes();
   int nb_part = S.size();
   int nb_iter_implicit=0;
@@ -243,44 +355,72 @@ int main(){
   double variation_energy= 0.;
   double variation_volume = 0.;
   double volume_solide = 0.;
+  //Cumulated times of the phases, whose variation over the time-step is written in the time series
+  double* const temps_phases[] = {&temps_flux, &temps_explicit, &temps_intersections, &temps_semi_implicit, &temps_solide_f_int,
+				  &temps_solide_vitesse, &temps_swap, &temps_modif_fnum, &temps_mixage, &temps_fill_cel, &temps_BC, &temps_total};
+  const int nb_phases = sizeof(temps_phases)/sizeof(temps_phases[0]);
+  double temps_phases_debut[nb_phases];
+  std::signal(SIGINT,Arret_signal);
+  std::signal(SIGTERM,Arret_signal);
 	
   for (int n=0; (t<T) && n<Nmax; n++){
     user_time_total.start();
+    journal.Iteration(n);
+    for(int p=0; p<nb_phases; p++){
+      temps_phases_debut[p] = *temps_phases[p];
+    }
+    int iterations_semi_implicite = 0;
 
-    cout<<"iteration="<<n<< " dt="<<dt<<" t="<<t<<endl;
+    JOURNAL(journal_pas_de_temps,journal_resume)<<"iteration="<<n<< " dt="<<dt<<" t="<<t<<"\n";
     			
     			
     if(t>next_timp){
-      Fluide.Impression(kimp);
-      S.Impression(kimp);
-      sorties_reprise << t << endl;
+      ecriture.Ajoute(Fluide,S,kimp,t);
+      sorties_reprise << t << "\n";
       kimp++;
       next_timp += dtimp;
+      if(sauvegarde_reprise){
+	Etat_reprise etat = {t, kimp, next_timp, E0, E0S, masse, volume_initial, iter_reprise+iter};
+	Sauvegarde_reprise(kimp-1,Fluide,S,Aitken,etat,cumuls_fluide ? &cumuls : NULL);
+	if(cumuls_fluide){
+	  Ecrit_cumuls(cumuls);
+	}
+      }
     }
-    cout<<"Fluid energy: "<< Fluide.Energie() << " Solid energy:" << S.Energie() <<"  "<<"Fluid mass : "<<"  "<< Fluide.Masse() <<endl;
-    ener << t << " " << Fluide.Energie()+S.Energie() << " " << S.Energie() << " " << Fluide.Energie()+S.Energie()-E0 << " " << S.Energie()-E0S <<" "<<Fluide.Masse() - masse <<endl;
-    cout<<"Variation Energie: "<< Fluide.Energie() +  S.Energie() - E0<<" Variation Masse : "<< Fluide.Masse() - masse<<endl;
+    coupes.Sorties(Fluide,t);
+    JOURNAL(journal_bilan,journal_diagnostic)<<"Fluid energy: "<< bilan.energie_fluide << " Solid energy:" << bilan.Energie_solide() <<"  "<<"Fluid mass : "<<"  "<< bilan.masse <<"  "<<"Fluid momentum : "<< bilan.impx << " " << bilan.impy << " " << bilan.impz <<"\n";
+    const double ligne_energie[6] = {t, bilan.Energie(), bilan.Energie_solide(), bilan.Energie()-E0, bilan.Energie_solide()-E0S, bilan.masse - masse};
+    ener.Ajoute(ligne_energie);
+    JOURNAL(journal_bilan,journal_diagnostic)<<"Variation Energie: "<< bilan.Energie() - E0<<" Variation Masse : "<< bilan.masse - masse<<"\n";
     //Time step
-    dt = min(Fluide.pas_temps(t, T),S.pas_temps(t,T));
+    double dt_f = Fluide.pas_temps(t, T);
+    double dt_s = S.pas_temps(t,T);
+    //Solid sub-cycles: the fluid forces are frozen during the fluid time-step
+    int n_sub = max(1,min(n_sub_max,int(ceil(dt_f/dt_s))));
+    dt = min(dt_f,n_sub*dt_s);
 
-    Fluide.affiche();
+    if(journal.actif(journal_bilan,journal_detail)){
+      Fluide.affiche();
+    }
     user_time2.start();
 
     Fluide.Solve(dt, t, n, S);
 
-    Fluide.affiche();
+    if(journal.actif(journal_bilan,journal_detail)){
+      Fluide.affiche();
+    }
     temps_flux += CGAL::to_double(user_time2.time());
     user_time2.reset();
     if(explicite){ //Explicit coupling algorithm
       user_time4.start();
-      cout <<"Forces_fluide Mass Variation : "<< Fluide.Masse() - masse<<endl;
+      Controle_masse("Forces_fluide",Fluide,masse,n);
       Fluide.Forces_fluide(S,dt);
-      cout <<"Solve_position Mass Variation : "<< Fluide.Masse() - masse<<endl;
-      S.Solve_position(dt);
+      Controle_masse("Solve_position",Fluide,masse,n);
+      S.Solve_position(dt,n_sub);
       temps_explicit += CGAL::to_double(user_time4.time());
       user_time4.reset();
       user_time4.start();
-      cout <<"Parois_particles Mass Variation : "<< Fluide.Masse() - masse<<endl;
+      Controle_masse("Parois_particles",Fluide,masse,n);
       Fluide.Parois_particles(S,dt);
       temps_intersections += CGAL::to_double(user_time4.time());
       user_time4.reset();
@@ -288,47 +428,58 @@ int main(){
 			
     else{ //Semi-implicit coupling algorithm
       //semi-implicit
-      int kmax=20;
       double erreur = 1.;
       user_time5.start();
       Solide Sk = S;
-      Solide Sk_prev = Sk;
+      Etat_solide etat_S, etat_Sk_prev; //Kinematic snapshots: the geometry of Sk is not copied at each iteration
+      S.Sauvegarde(etat_S);
       int k;
-      for(k=0;(erreur>1.e-10) && (k<kmax) ;k++){
-	cout <<"Forces_fluide semiimpl Mass Variation : "<< Fluide.Masse() - masse<<endl;
+      for(k=0;(erreur>tol_semi_implicite) && (k<kmax_semi_implicite) ;k++){
+	Controle_masse("Forces_fluide semiimpl",Fluide,masse,n);
 	Fluide.Forces_fluide(Sk,dt);
-	Copy_f_m(S,Sk); //This function is important to prevent erasing Sk.F_f et Sk.M_f!!!!!
-	Sk_prev = Sk; 
-	Sk = S ;
-	cout <<"Solve_position semiimpl Mass Variation : "<< Fluide.Masse() - masse<<endl;
-	Sk.Solve_position(dt);
-	cout <<"Parois_particles semiimpl Mass Variation : "<< Fluide.Masse() - masse<<endl;
+	Aitken.Relaxation(S,Sk,k); //Relaxed copy of Sk.F_f and Sk.M_f in S, to prevent erasing them!!!!!
+	Sk.Sauvegarde(etat_Sk_prev);
+	if(!Sk.Restauration(etat_S)){
+	  Sk = S;
+	}
+	Copy_f_m(Sk,S);
+	Controle_masse("Solve_position semiimpl",Fluide,masse,n);
+	Sk.Solve_position(dt,n_sub);
+	Controle_masse("Parois_particles semiimpl",Fluide,masse,n);
 	Fluide.Parois_particles(Sk,dt);
-	erreur = Error(Sk, Sk_prev);
+	erreur = Error(Sk, etat_Sk_prev);
       }//end semi-implicit fixed point loop on surfaces
       S=Sk;
+      Aitken.Fin(k);
       temps_semi_implicit += CGAL::to_double(user_time4.time());
       user_time5.reset();
-      cout<<"number of semi-implicit iterations: "<<k<<endl;
+      JOURNAL(journal_couplage,journal_diagnostic)<<"number of semi-implicit iterations: "<<k<<" relaxation: "<<Aitken.omega<<"\n";
+      if(journal.actif(journal_couplage,journal_detail)){
+	Aitken.Affiche_histogramme(journal.flux());
+      }
       nb_iter_implicit += k;
+      iterations_semi_implicite = k;
       //semi-implicit	
     }
+    for(int r=0; r<S.ruptures.size(); r++){
+      ruptures << t << " " << S.ruptures[r].lien << " " << S.ruptures[r].i << " " << S.ruptures[r].j << " " << S.ruptures[r].allongement << "\n";
+    }
     user_time3.start();
-    cout <<"Forces_internes Mass Variation : "<< Fluide.Masse() - masse<<endl;
+    Controle_masse("Forces_internes",Fluide,masse,n);
     S.Forces_internes();
     temps_solide_f_int += CGAL::to_double(user_time3.time());
     user_time3.reset();
-    cout <<"Solve_vitesse Mass Variation : "<< Fluide.Masse() - masse<<endl;
+    Controle_masse("Solve_vitesse",Fluide,masse,n);
     user_time3.start();
-    S.Solve_vitesse(dt);
+    S.Solve_vitesse(dt/n_sub);
     temps_solide_vitesse += CGAL::to_double(user_time3.time());
     user_time3.reset();
     user_time.start();
-    cout <<"Swap_2d Mass Variation : "<< Fluide.Masse() - masse<<endl;
+    Controle_masse("Swap_2d",Fluide,masse,n);
     Fluide.Swap_2d(dt,S);
     temps_swap += CGAL::to_double(user_time.time());
     user_time.reset();
-    cout <<"Modif_fnum Mass Variation : "<< Fluide.Masse() - masse<<endl;
+    Controle_masse("Modif_fnum",Fluide,masse,n);
     user_time.start();
     Fluide.Modif_fnum(dt);
     temps_modif_fnum += CGAL::to_double(user_time.time());
@@ -336,58 +487,101 @@ int main(){
     user_time.start();
     bool test_fini = false;
     for(int count=1;!test_fini && count<100;count++){
-      cout <<"Mixage_cible2 iteration " << count << " Mass Variation : "<< Fluide.Masse() - masse<<endl;
+      Controle_masse("Mixage_cible2",Fluide,masse,n);
       test_fini = Fluide.Mixage_cible2(); 
-      cout << "iterations of Mixage_cible2=" << count << endl;
+      JOURNAL(journal_couplage,journal_detail) << "iterations of Mixage_cible2=" << count << "\n";
     }
     temps_mixage += CGAL::to_double(user_time.time());
     user_time.reset();
     user_time.start();
-    cout <<"Fill_cel Mass Variation : "<< Fluide.Masse() - masse<<endl;
+    Controle_masse("Fill_cel",Fluide,masse,n);
     Fluide.Fill_cel(S);
     temps_fill_cel += CGAL::to_double(user_time.time());
     user_time.reset();
     user_time.start();
-    cout <<"BC Variation Masse : "<< Fluide.Masse() - masse<<endl;
+    Controle_masse("BC",Fluide,masse,n);
     Fluide.BC();
-    cout <<"BC_couplage Variation Masse : "<< Fluide.Masse() - masse<<endl;
+    Controle_masse("BC_couplage",Fluide,masse,n);
     
     temps_BC += CGAL::to_double(user_time.time());
     user_time.reset();
 			
     t+= dt;
     iter++;
-    variation_masse += Fluide.Masse() - masse;
-    variation_energy += Fluide.Energie()+S.Energie()-E0;
-    volume_solide = 0.;
-    for (int count=0; count<S.size(); count++){
-      volume_solide +=S.solide[count].volume();
+    bilan.Calcul(Fluide,S,cumuls_fluide ? &cumuls : NULL,dt);
+    sondes.Echantillonne(Fluide,S,iter_reprise+iter,t);
+    variation_masse += bilan.masse - masse;
+    variation_energy += bilan.Energie()-E0;
+    //The volume of the solid is only computed for diagnostics
+    if(niveau_journal>=journal_diagnostic){
+      volume_solide = 0.;
+      for (int count=0; count<S.size(); count++){
+	volume_solide +=S.solide[count].volume();
+      }
+      JOURNAL(journal_bilan,journal_diagnostic)<<"volume solid particles "<<volume_solide<<"\n";
+      variation_volume += volume_solide - volume_initial;
     }
-    //Fluide.affiche();
-    cout<<"volume solid particles "<<volume_solide<<endl;
-    variation_volume += volume_solide - volume_initial;
 
 		
     temps_total += CGAL::to_double(user_time_total.time());
     user_time_total.reset();
-    cout << "############## COUTS #################" << endl;
-    cout << "Fluide Solve=    " << 100*temps_flux/temps_total << "%     " << temps_flux/(n+1.) << endl;
-    cout << "Solide solve=    " << 100*temps_explicit/temps_total << "%     " << temps_explicit/(n+1.)  << endl;
-    cout << "Parois particles=" << 100*temps_intersections/temps_total << "%     " << temps_intersections/(n+1.) << endl;
-    cout << "Forces internes= " << 100*temps_solide_f_int/temps_total << "%     " << temps_solide_f_int/(n+1.) << endl;
-    cout << "Solve vitesse=   " << 100*temps_solide_vitesse/temps_total << "%     " << temps_solide_vitesse/(n+1.) << endl;
-    cout << "Swap2d=          " << 100*temps_swap/temps_total << "%     " << temps_swap/(n+1.) << endl;
-    cout << "Modif fnum=      " << 100*temps_modif_fnum/temps_total << "%     " << temps_modif_fnum/(n+1.) << endl;
-    cout << "Mixage=          " << 100*temps_mixage/temps_total << "%     " << temps_mixage/(n+1.) << endl;
-    cout << "Fill cel=        " << 100*temps_fill_cel/temps_total <<"%     " << temps_fill_cel/(n+1.) << endl;
-    cout << "BC=              " << 100*temps_BC/temps_total << "%     " << temps_BC/(n+1.) << endl;
-    cout << "Rest=           " << 100-100*(temps_flux+temps_explicit+temps_intersections+temps_solide_f_int+temps_solide_vitesse+temps_swap+temps_modif_fnum+temps_mixage+temps_fill_cel+temps_BC)/temps_total << "%     " << (temps_total-(temps_flux+temps_explicit+temps_intersections+temps_solide_f_int+temps_solide_vitesse+temps_swap+temps_modif_fnum+temps_mixage+temps_fill_cel+temps_BC))/(n+1.) << endl;
-    cout << "########################################" << endl;
+    double ligne_series[nb_colonnes_series] = {t, dt, bilan.Energie(), bilan.Energie_solide(), bilan.Energie()-E0, bilan.Energie_solide()-E0S, bilan.masse - masse, double(n_sub), double(iterations_semi_implicite)};
+    for(int p=0; p<nb_phases; p++){
+      ligne_series[nb_colonnes_series-nb_phases+p] = *temps_phases[p]-temps_phases_debut[p];
+    }
+    series.Ajoute(ligne_series);
+    if(iter%pas_series==0){
+      sorties_reprise.flush();
+      ruptures.flush();
+    }
+    if(journal.actif(journal_couts,journal_detail)){
+      journal.flux() << "############## COUTS #################" << "\n";
+      journal.flux() << "Fluide Solve=    " << 100*temps_flux/temps_total << "%     " << temps_flux/(n+1.) << "\n";
+      journal.flux() << "Solide solve=    " << 100*temps_explicit/temps_total << "%     " << temps_explicit/(n+1.)  << "\n";
+      journal.flux() << "Parois particles=" << 100*temps_intersections/temps_total << "%     " << temps_intersections/(n+1.) << "\n";
+      journal.flux() << "Forces internes= " << 100*temps_solide_f_int/temps_total << "%     " << temps_solide_f_int/(n+1.) << "\n";
+      journal.flux() << "Solve vitesse=   " << 100*temps_solide_vitesse/temps_total << "%     " << temps_solide_vitesse/(n+1.) << "\n";
+      journal.flux() << "Swap2d=          " << 100*temps_swap/temps_total << "%     " << temps_swap/(n+1.) << "\n";
+      journal.flux() << "Modif fnum=      " << 100*temps_modif_fnum/temps_total << "%     " << temps_modif_fnum/(n+1.) << "\n";
+      journal.flux() << "Mixage=          " << 100*temps_mixage/temps_total << "%     " << temps_mixage/(n+1.) << "\n";
+      journal.flux() << "Fill cel=        " << 100*temps_fill_cel/temps_total <<"%     " << temps_fill_cel/(n+1.) << "\n";
+      journal.flux() << "BC=              " << 100*temps_BC/temps_total << "%     " << temps_BC/(n+1.) << "\n";
+      journal.flux() << "Rest=           " << 100-100*(temps_flux+temps_explicit+temps_intersections+temps_solide_f_int+temps_solide_vitesse+temps_swap+temps_modif_fnum+temps_mixage+temps_fill_cel+temps_BC)/temps_total << "%     " << (temps_total-(temps_flux+temps_explicit+temps_intersections+temps_solide_f_int+temps_solide_vitesse+temps_swap+temps_modif_fnum+temps_mixage+temps_fill_cel+temps_BC))/(n+1.) << "\n";
+      journal.flux() << "########################################" << "\n";
+    }
+    journal.Vide();
+    if(anomalies.arret_demande()){
+      //The state at the end of the time-step and the checkpoint are written after the loop
+      cout << "Anomaly detected at t=" << t << ": computation stopped, see resultats/anomalies.dat" << endl;
+      sorties_reprise << t << "\n";
+      break;
+    }
+    if(signal_recu){
+      //The state at the end of the time-step and the checkpoint are written after the loop
+      cout << "Signal " << signal_recu << " received at t=" << t << ": computation stopped" << endl;
+      sorties_reprise << t << "\n";
+      break;
+    }
 		
   }
   end=clock();
-  Fluide.Impression(kimp);
-  S.Impression(kimp);
+  journal.Vide();
+  sondes.Vide();
+  ener.Vide();
+  series.Vide();
+  sorties_reprise.flush();
+  ruptures.flush();
+  ecriture.Ajoute(Fluide,S,kimp,t);
+  //The checkpoint is always written when the computation is stopped by an anomaly or a signal, whatever sauvegarde_reprise
+  if(sauvegarde_reprise || anomalies.arret_demande() || signal_recu){
+    Etat_reprise etat = {t, kimp+1, next_timp, E0, E0S, masse, volume_initial, iter_reprise+iter};
+    Sauvegarde_reprise(kimp,Fluide,S,Aitken,etat,cumuls_fluide ? &cumuls : NULL);
+  }
+  if(cumuls_fluide){
+    Ecrit_cumuls(cumuls);
+  }
+  ecriture.Termine();
+  journal.Vide();
 	
   temps_iter<< "Final time  "<< t<<endl;
   temps_iter<<"Nb iter= "<< iter<<endl;    
@@ -400,12 +594,22 @@ int main(){
   temps_iter<<"Temps couplage " << temps_swap + temps_intersections + temps_semi_implicit<< endl; 
   temps_iter<<" variation masse "<< variation_masse<<endl;
   temps_iter<<" variation energy "<<variation_energy<<endl;
-  temps_iter<<" variation volume "<<variation_volume<<endl;
+  if(niveau_journal>=journal_diagnostic){
+    temps_iter<<" variation volume "<<variation_volume<<endl;
+  }
+  if(!explicite){
+    temps_iter<<"Nb iter semi-implicit= "<< nb_iter_implicit<<endl;
+    Aitken.Affiche_histogramme(temps_iter);
+  }
+  anomalies.Affiche(temps_iter);
+  anomalies.Affiche(cout);
   cout<<"Nb iter= "<< iter<<endl;    
   cout <<"Temps calcul " <<(double) (end-start)/CLOCKS_PER_SEC << endl;  
   cout<<" variation masse "<< variation_masse<<endl;
   cout<<" variation energy "<<variation_energy<<endl;
-  cout<<" variation volume "<<variation_volume<<endl;
+  if(niveau_journal>=journal_diagnostic){
+    cout<<" variation volume "<<variation_volume<<endl;
+  }
 
   cout << "Fluide Solve=" << 100*temps_flux/temps_total << "%" << endl;
   cout << "Solide solve=" << 100*temps_explicit/temps_total << "%"  << endl;
@@ -420,5 +624,8 @@ int main(){
   cout << "Reste=" << 100-100*(temps_flux+temps_explicit+temps_intersections+temps_solide_f_int+temps_solide_vitesse+temps_swap+temps_modif_fnum+temps_mixage+temps_fill_cel+temps_BC)/temps_total << "%" << endl;
 	
 
-  return 0;
+  if(signal_recu){
+    return 128+signal_recu;
+  }
+  return anomalies.arret_demande() ? EXIT_FAILURE : 0;
 }
@@ -18,6 +18,8 @@
 */
 
 #include "parametres.hpp"
+#include "anomalies.hpp"
+#include "sorties.hpp"
 //!\file
 //!\authors Laurent Monasse and Maria Adela Puscas
 
@@ -29,218 +31,155 @@ double vi[Nx][Ny][Nz];
 double wi[Nx][Ny][Nz];
 double pi[Nx][Ny][Nz];
 
-void reprise(){
-  std::ostringstream oss;
-  oss << "resultats/fluide" << numrep << ".vtk";
-  string s = oss.str();
-  const char* nom = s.c_str();
-  std::ifstream init(nom,std::ios::in);
-  string dump;
-  getline(init,dump);
-  getline(init,dump);
-  getline(init,dump);
-  getline(init,dump);
-  getline(init,dump);
-  char points[7];
-  int Np;
-  char Double[7];
-  init >> points >> Np >> Double;
-  double indexp[Np][3];
-  for(int i=0;i<Np;i++){
-    init>>indexp[i][0]>>indexp[i][1]>>indexp[i][2];
+/*!\brief Reads the lines of \a in until the header of section \a mot of a vtk file.
+   \param in input flux
+   \param mot keyword of the section (POINTS, CELLS...)
+   \param ligne header line of the section
+   \return false if the section is not found
+*/
+bool Section_vtk(std::istream& in, const string& mot, string& ligne){
+  while(getline(in,ligne)){
+    if(ligne.compare(0,mot.size(),mot)==0){
+      return true;
+    }
+  }
+  return false;
+}
+
+/*!\brief Fills the initial field \a champ with the values \a valeurs of the fluid cells read in the restart file. Between two fluid cells, the value of the first one is used.
+   \param champ initial field
+   \param index index k+Nz*j+Nz*Ny*i of the fluid cells
+   \param valeurs values in the fluid cells
+   \return void
+*/
+void Remplit_reprise(double (*champ)[Ny][Nz], const std::vector<int>& index, const std::vector<double>& valeurs){
+  const int N = valeurs.size();
+  for(int l=0;l<N;l++){
+    const int it0 = index[l];
+    const int it1 = (l<N-1) ? index[l+1] : Nx*Ny*Nz-1;
+    for(int it=it0;it==it0 || it<it1;it++){
+      int ktemp = it%Nz;
+      int jtemp = (it/Nz)%Ny;
+      int itemp = it/(Nz*Ny);
+      champ[itemp][jtemp][ktemp] = valeurs[l];
+    }
+  }
+}
+
+/*!\brief Recovery of the fluid initial conditions from an output file on the whole Cartesian grid (STRUCTURED_POINTS).
+   \details The fields are read on all the cells, then only the fluid cells are kept, as for an output on the fluid cells only.
+   \param init input flux, after the DATASET line
+   \param nom name of the file
+   \param binaire binary (true) or ASCII (false) file
+   \return void
+*/
+void reprise_structuree(std::istream& init, const char* nom, const bool binaire){
+  string ligne;
+  //Pressure, density, velocity components and solid occupancy ratio
+  double (*champs[5])[Ny][Nz] = {pi, rhoi, ui, vi, wi};
+  std::vector<double> valeurs[6];
+  for(int m=0;m<6;m++){
+    valeurs[m].resize(Nx*Ny*Nz);
+    if(Section_vtk(init,"SCALARS",ligne)){
+      getline(init,ligne);
+      Lit_tableau_vtk(init,valeurs[m],binaire);
+    }
     if(!init){
-      cout << "Problem " << i << endl;
-      getchar();
+      anomalies.Signale(anomalie_lecture_reprise,0.) << nom << " field " << m << "\n";
+      if(anomalies.arret_demande()){
+	cout << "Read error in " << nom << ": see resultats/anomalies.dat" << endl;
+	exit(EXIT_FAILURE);
+      }
+      return;
     }
   }
-  char cells[6];
-  int N;
-  int Ninfo;
-  init>>cells>>N>>Ninfo;
-  
-  //Recovery of indices where alpha is not zero
-  int index[N][3];
-  int indice;
-  double x,y,z;
-  int trash;
-  init >> trash >> indice >> trash >> trash >> trash >> trash >> trash >> trash >> trash;
-  x = indexp[indice][0];
-  y = indexp[indice][1];
-  z = indexp[indice][2];
-  int l=0;
+  std::vector<int> index;
+  std::vector<double> fluide[5];
   for(int i=0;i<Nx;i++){
     for(int j=0;j<Ny;j++){
       for(int k=0;k<Nz;k++){
-	if(abs(i*deltax-x)<0.1*deltax && abs(j*deltay-y)<0.1*deltay && abs(k*deltaz-z)<0.1*deltaz){
-	  index[l][0] = i;
-	  index[l][1] = j;
-	  index[l][2] = k;
-	  l++;
-	  if(l<N){
-	    init >> trash >> indice >> trash >> trash >> trash >> trash >> trash >> trash >> trash;
-	    x = indexp[indice][0];
-	    y = indexp[indice][1];
-	    z = indexp[indice][2];
+	const int n = i+Nx*(j+Ny*k);
+	if(abs(valeurs[5][n]-1.)>eps){
+	  index.push_back(k+Nz*j+Nz*Ny*i);
+	  for(int m=0;m<5;m++){
+	    fluide[m].push_back(valeurs[m][n]);
 	  }
 	}
       }
     }
   }
-  //Dump the type of cells
-  for(int i=0;i<N+2;i++){
-    getline(init,dump);
+  for(int m=0;m<5;m++){
+    Remplit_reprise(champs[m],index,fluide[m]);
   }
-	
-  //Recover pressure
-  getline(init,dump);
-  getline(init,dump);
-  getline(init,dump);
-  getline(init,dump);
-  getline(init,dump);
-  for(int l=0;l<N;l++){
-    double p;
-    init >> p;
-    int i = index[l][0];
-    int j = index[l][1];
-    int k = index[l][2];
-    pi[i][j][k] = p;
-    //Between two points with alpha<1, fill with the same value
-    int i1 = Nx-1;
-    int j1 = Ny-1;
-    int k1 = Nz-1;
-    if(l<N-1){
-      i1 = index[l+1][0];
-      j1 = index[l+1][1];
-      k1 = index[l+1][2];
-    }
-    if(k1+Nz*j1+Nz*Ny*i1-(k+Nz*j+Nz*Ny*i)>1){
-      for(int it=k+Nz*j+Nz*Ny*i+1;it<k1+Nz*j1+Nz*Ny*i1;it++){
-	int ktemp = it%Nz;
-	int jtemp = ((it-ktemp)/Nz)%Ny;
-	int itemp = (((it-ktemp)/Nz)-jtemp)/Ny;
-	pi[itemp][jtemp][ktemp] = p;
-      }
-    }
+}
+
+/*!\brief Recovery of the fluid initial conditions from output file fluide<numrep>.vtk (ASCII or binary, on the fluid cells or on the whole grid).
+   \return void
+*/
+void reprise(){
+  std::ostringstream oss;
+  oss << "resultats/fluide" << numrep << ".vtk";
+  string s = oss.str();
+  const char* nom = s.c_str();
+  std::ifstream init(nom,std::ios::in|std::ios::binary);
+  string ligne, mot;
+  getline(init,ligne);
+  getline(init,ligne);
+  getline(init,ligne);
+  const bool binaire = (ligne.compare(0,6,"BINARY")==0);
+  Section_vtk(init,"DATASET",ligne);
+  if(ligne.find("STRUCTURED_POINTS")!=string::npos){
+    reprise_structuree(init,nom,binaire);
+    return;
   }
-  //Recovery of density
-  getline(init,dump);
-  getline(init,dump);
-  getline(init,dump);
-  getline(init,dump);
-  for(int l=0;l<N;l++){
-    double rho;
-    init >> rho;
-    int i = index[l][0];
-    int j = index[l][1];
-    int k = index[l][2];
-    rhoi[i][j][k] = rho;
-    //Between two points with alpha<1, fill with the same value
-    int i1 = Nx-1;
-    int j1 = Ny-1;
-    int k1 = Nz-1;
-    if(l<N-1){
-      i1 = index[l+1][0];
-      j1 = index[l+1][1];
-      k1 = index[l+1][2];
-    }
-    if(k1+Nz*j1+Nz*Ny*i1-(k+Nz*j+Nz*Ny*i)>1){
-      for(int it=k+Nz*j+Nz*Ny*i+1;it<k1+Nz*j1+Nz*Ny*i1;it++){
-	int ktemp = it%Nz;
-	int jtemp = ((it-ktemp)/Nz)%Ny;
-	int itemp = (((it-ktemp)/Nz)-jtemp)/Ny;
-	rhoi[itemp][jtemp][ktemp] = rho;
-      }
-    }
+  
+  //Points: the cells are identified by their first point
+  int Np = 0;
+  if(Section_vtk(init,"POINTS",ligne)){
+    std::istringstream(ligne) >> mot >> Np;
   }
-  //Recovery of u
-  getline(init,dump);
-  getline(init,dump);
-  getline(init,dump);
-  getline(init,dump);
-  for(int l=0;l<N;l++){
-    double u;
-    init >> u;
-    int i = index[l][0];
-    int j = index[l][1];
-    int k = index[l][2];
-    ui[i][j][k] = u;
-    //Between two points with alpha<1, fill with the same value
-    int i1 = Nx-1;
-    int j1 = Ny-1;
-    int k1 = Nz-1;
-    if(l<N-1){
-      i1 = index[l+1][0];
-      j1 = index[l+1][1];
-      k1 = index[l+1][2];
-    }
-    if(k1+Nz*j1+Nz*Ny*i1-(k+Nz*j+Nz*Ny*i)>1){
-      for(int it=k+Nz*j+Nz*Ny*i+1;it<k1+Nz*j1+Nz*Ny*i1;it++){
-	int ktemp = it%Nz;
-	int jtemp = ((it-ktemp)/Nz)%Ny;
-	int itemp = (((it-ktemp)/Nz)-jtemp)/Ny;
-	ui[itemp][jtemp][ktemp] = u;
-      }
-    }
+  std::vector<double> points(3*Np);
+  Lit_tableau_vtk(init,points,binaire);
+  int N = 0, Ninfo = 0;
+  if(Section_vtk(init,"CELLS",ligne)){
+    std::istringstream(ligne) >> mot >> N >> Ninfo;
   }
-  //Recovery of v
-  getline(init,dump);
-  getline(init,dump);
-  getline(init,dump);
-  getline(init,dump);
-  for(int l=0;l<N;l++){
-    double v;
-    init >> v;
-    int i = index[l][0];
-    int j = index[l][1];
-    int k = index[l][2];
-    vi[i][j][k] = v;
-    //Between two points with alpha<1, fill with the same value
-    int i1 = Nx-1;
-    int j1 = Ny-1;
-    int k1 = Nz-1;
-    if(l<N-1){
-      i1 = index[l+1][0];
-      j1 = index[l+1][1];
-      k1 = index[l+1][2];
-    }
-    if(k1+Nz*j1+Nz*Ny*i1-(k+Nz*j+Nz*Ny*i)>1){
-      for(int it=k+Nz*j+Nz*Ny*i+1;it<k1+Nz*j1+Nz*Ny*i1;it++){
-	int ktemp = it%Nz;
-	int jtemp = ((it-ktemp)/Nz)%Ny;
-	int itemp = (((it-ktemp)/Nz)-jtemp)/Ny;
-	vi[itemp][jtemp][ktemp] = v;
-      }
+  std::vector<int> cellules(Ninfo);
+  Lit_tableau_vtk(init,cellules,binaire);
+  if(!init || Np==0 || Ninfo!=9*N){
+    anomalies.Signale(anomalie_lecture_reprise,0.) << nom << " points/cells" << "\n";
+    if(anomalies.arret_demande()){
+      cout << "Read error in " << nom << ": see resultats/anomalies.dat" << endl;
+      exit(EXIT_FAILURE);
     }
+    return;
   }
-  //Recovery of w
-  getline(init,dump);
-  getline(init,dump);
-  getline(init,dump);
-  getline(init,dump);
+  std::vector<int> index(N);
   for(int l=0;l<N;l++){
-    double w;
-    init >> w;
-    int i = index[l][0];
-    int j = index[l][1];
-    int k = index[l][2];
-    wi[i][j][k] = w;
-    //Between two points with alpha<1, fill with the same value
-    int i1 = Nx-1;
-    int j1 = Ny-1;
-    int k1 = Nz-1;
-    if(l<N-1){
-      i1 = index[l+1][0];
-      j1 = index[l+1][1];
-      k1 = index[l+1][2];
+    const int p0 = cellules[9*l+1];
+    const int k = p0%(Nz+1);
+    const int j = (p0/(Nz+1))%(Ny+1);
+    const int i = p0/((Nz+1)*(Ny+1));
+    index[l] = k+Nz*j+Nz*Ny*i;
+  }
+  
+  //Recovery of pressure, density and velocity
+  double (*champs[5])[Ny][Nz] = {pi, rhoi, ui, vi, wi};
+  std::vector<double> valeurs(N);
+  for(int m=0;m<5;m++){
+    if(Section_vtk(init,"SCALARS",ligne)){
+      getline(init,ligne);
+      Lit_tableau_vtk(init,valeurs,binaire);
     }
-    if(k1+Nz*j1+Nz*Ny*i1-(k+Nz*j+Nz*Ny*i)>1){
-      for(int it=k+Nz*j+Nz*Ny*i+1;it<k1+Nz*j1+Nz*Ny*i1;it++){
-	int ktemp = it%Nz;
-	int jtemp = ((it-ktemp)/Nz)%Ny;
-	int itemp = (((it-ktemp)/Nz)-jtemp)/Ny;
-	wi[itemp][jtemp][ktemp] = w;
+    if(!init){
+      anomalies.Signale(anomalie_lecture_reprise,0.) << nom << " field " << m << "\n";
+      if(anomalies.arret_demande()){
+	cout << "Read error in " << nom << ": see resultats/anomalies.dat" << endl;
+	exit(EXIT_FAILURE);
       }
+      return;
     }
+    Remplit_reprise(champs[m],index,valeurs);
   }
 }
 
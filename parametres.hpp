@@ -53,6 +53,17 @@ bool flag_2d = false;
 bool couplage1d=false;
 const bool exact_swap=false;
 
+/*! 
+ * \warning  <b> Specific coupling parameters ! </b>
+ */
+//! \brief Semi-implicit coupling: fixed-point iterations on the fluid forces and torques (see \a Relaxation_Aitken).
+const int kmax_semi_implicite = 20;        //!< Maximal number of fixed-point iterations per time-step
+const double tol_semi_implicite = 1.e-10;  //!< Convergence tolerance on the solid displacement
+const bool relaxation_aitken = true;       //!< Dynamic Aitken relaxation of the fixed-point iterations (false: plain fixed point)
+const double omega_max = 1.;               //!< Upper bound of the relaxation factor (also used at the first relaxed iteration)
+const double omega_min = 1.e-2;            //!< Lower bound of the relaxation factor
+const bool extrapolation_forces = true;    //!< Initial guess of the fluid forces extrapolated from the previous time-step
+
 //Fluid parameters
 const double gam = 1.4;                   //!<Perfect gas constant 
 const double eps =  0.00000000000001;     //!<Numerical stabilization 
@@ -83,14 +94,75 @@ const double rhos = 2698.9; //!<Solid density
 const double nu = 0.; //!<Poisson's ratio
 const double E = 5.; //!<Young's modulus
 const double k_max = 0.01; //!<Elongation at break
+const bool solide_reproductible = true; //!<Solid reductions (energies) summed in a fixed order, so that the results do not depend on the number of threads
 
 //Parametres temprels
 const double T = 0.1;             //!<Total simulation time
 const double cfl = 0.5;            //!<Fluid CFL condition
 const double cfls = 0.5;           //!<Solid CFL condition
+const int n_sub_max = 1;           //!<Maximal number of solid sub-cycles per fluid time-step (1: no sub-cycling)
 const int nimp = 10;                //!<Number of outputs
 const double dtimp = T/nimp;        //!<Time-step between two consecutive outputs
+const bool sortie_binaire = true;   //!<Fluid outputs fluide*.vtk in binary (legacy vtk format, big-endian) instead of ASCII
+const bool sortie_structuree = true; //!<Fluid outputs fluide*.vtk on the whole Cartesian grid (STRUCTURED_POINTS, with field alpha) instead of the fluid cells only (UNSTRUCTURED_GRID)
+const bool sortie_solide_indexee = true; //!<Solid outputs solide*.vtk with a table of shared vertices, the kinematics written once per particle (field data) and the index of the particle of each triangle, in binary if \a sortie_binaire
+const bool trajectoire_solide = false; //!<Positions of the solid vertices also appended at each output to resultats/solide_trajectoire.bin, as single precision differences with the previous output
+const int periode_cle_solide = 10; //!<Number of outputs between two positions written in double precision (key frames) in solide_trajectoire.bin
+const bool ecriture_asynchrone = true; //!<Output files written by a background thread while the computation goes on
+const int taille_file_ecriture = 2; //!<Maximal number of outputs waiting for writing (each one holds a copy of the fluid fields)
+const bool sauvegarde_reprise = false; //!<Binary checkpoint resultats/reprise*.bin written with each output (restart with ./main resultats/reprise*.bin). Each checkpoint holds all the cells, ghost cells included, and is kept
+const bool cumuls_fluide = false; //!<Time-integral, mean, maximum and minimum in each cell of the pressure and of the effective pressures pdtx/dt, pdty/dt, pdtz/dt, written in resultats/cumuls.vtk at the end and with each checkpoint
 const int Nmax = 1000000;           //!<Maximal number of time iterations
+const int pas_controle_masse = 0;   //!<Stride (in time iterations) of the mass checks after each phase of the time-step (0: no check)
+const int pas_sondes = 1;           //!<Default stride (in time iterations) of the sampling of the probes of sondes.dat
+const int taille_tampon_sondes = 4096; //!<Number of samples of the probes kept in memory before writing them in resultats/sondes.bin
+
+//!Console output
+//! \brief Levels of the console output: a message is written if its level is at most \a niveau_journal.
+enum Niveau_journal {journal_production=0, //!<No diagnostic output, and no reduction computed only for display
+		     journal_resume=1,     //!<One line per time iteration
+		     journal_diagnostic=2, //!<Energy and mass balances, coupling diagnostics
+		     journal_detail=3      //!<Cost tables and intersection statistics
+};
+//! \brief Categories of the console output, each one with its own stride.
+enum Categorie_journal {journal_pas_de_temps, //!<Time iteration, time-step and time
+			journal_bilan,        //!<Energy, mass and volume balances
+			journal_couplage,     //!<Fluid forces, boundary fluxes, semi-implicit iterations and mixing
+			journal_intersections,//!<Statistics of the intersections between the grid and the solid
+			journal_couts,        //!<Cost tables
+			nb_categories_journal
+};
+const int niveau_journal = journal_diagnostic; //!<Level of the console output
+const int pas_journal[nb_categories_journal] = {1, 1, 1, 1, 100}; //!<Stride (in time iterations) of each category of the console output
+
+//!Anomalies
+//! \brief Policy applied when an anomaly is detected (negative squared speed of sound in the fluxes, negative pressure or density, restart read error). The anomaly is always recorded in resultats/anomalies.dat.
+enum Politique_anomalie {anomalie_continue,        //!<The computation goes on
+			 anomalie_arret,           //!<The state and the binary checkpoint (even if \a sauvegarde_reprise is false) are written at the end of the time-step and the computation stops
+			 anomalie_lax_friedrichs   //!<The flux at the faulty interface is replaced by the Lax-Friedrichs flux (negative squared speed of sound only)
+};
+const int politique_anomalie = anomalie_lax_friedrichs; //!<Policy applied when an anomaly is detected
+
+//!HDF5 outputs
+//! \brief Compression filter of the HDF5 datasets.
+enum Compression_hdf5 {hdf5_sans_compression, //!<No compression
+		       hdf5_gzip,             //!<Deflate filter, level \a niveau_gzip
+		       hdf5_lz4               //!<LZ4 filter (HDF5 plugin 32004); gzip is used if the plugin is not found
+};
+const bool sortie_hdf5 = false; //!<Outputs appended to resultats/resultats.h5, described for Paraview by resultats/resultats.xmf (XDMF), instead of the files fluide*.vtk and solide*.vtk. Requires compiling with -DCELIA3D_HDF5
+const int compression_hdf5 = hdf5_gzip; //!<Compression filter of the HDF5 datasets
+const int niveau_gzip = 4; //!<Level of the gzip compression (1 to 9)
+const int bloc_hdf5 = 32; //!<Size of the chunks of the fluid datasets in each direction
+
+//!Time series
+//! \brief Format of the file of time series resultats/series.*
+enum Format_series {series_texte,  //!<Values separated by spaces, without header
+		    series_csv,    //!<Header line with the names of the columns, values separated by commas
+		    series_binaire //!<Rows of doubles, the names of the columns in a .txt file
+};
+const int format_series = series_csv; //!<Format of resultats/series.csv or resultats/series.bin (time, time-step, energies, mass variation, sub-cycles, semi-implicit iterations and time of each phase, at each time iteration)
+const int pas_series = 100;   //!<Number of time iterations kept in memory before writing energie.dat, series.* and temps_reprise.dat
+const int precision_series = 12; //!<Number of significant digits of the time series written as text
 
 //!Boundary conditions
 //!Types of BC:  1 = reflecting; 2 = periodic; 3= outflow; 
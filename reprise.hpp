@@ -0,0 +1,645 @@
+//Copyright 2017 Laurent Monasse
+
+/*
+  This file is part of CELIA3D.
+
+  CELIA3D is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  CELIA3D is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with CELIA3D.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+   \file
+   \authors Laurent Monasse and Maria Adela Puscas
+   \brief Binary checkpoint of the whole simulation state and restart from it.
+   \details Layout of the file resultats/reprise<n>.bin (native byte order, checked with the marker 0x01020304):
+   - header: "CELIA3D", \a version_reprise, byte order marker, Nx, Ny, Nz, marge, number of particles, number of links, fields of \a Etat_reprise one by one in the order of their declaration (no padding), \a Solide.nb_positions;
+   - fluid: one array per field of \a champs_reprise, then \a Cellule.proche, \a Cellule.proche1 and \a Cellule.vide, on all the cells (ghost cells included);
+   - solid: broken links in the order of the breaks (\a Solide.liens_rompus), kinematics of each particle, then interface geometry of each triangle (\a Particule.Points_interface, \a Particule.Triangles_interface, \a Particule.Position_Triangles_interface);
+   - semi-implicit coupling: relaxation factors and force correction of \a Relaxation_Aitken;
+   - pressure accumulators: 1 and \a Cumuls_fluide if they are used, 0 otherwise.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "parametres.hpp"
+#include "anomalies.hpp"
+#include "fluide.hpp"
+#include "solide.hpp"
+
+#ifndef REPRISE_HPP
+#define REPRISE_HPP
+
+const int version_reprise = 4; //!< Version of the checkpoint layout, to increase when it changes
+const int marqueur_octets = 0x01020304; //!< Byte order marker of the checkpoint and of the binary series (\a Ecrit_entete_serie)
+
+//! \brief Time and global baselines of the simulation, stored in the checkpoint
+struct Etat_reprise
+{
+  double t;              //!< Simulation time
+  int kimp;              //!< Index of the next output
+  double next_timp;      //!< Time of the next output
+  double E0;             //!< Initial total energy
+  double E0S;            //!< Initial solid energy
+  double masse;          //!< Initial fluid mass
+  double volume_initial; //!< Initial volume of the solid
+  int iteration;         //!< Number of time iterations since the start of the simulation
+};
+
+//! Fields of \a Cellule stored in the checkpoint: conserved variables, primitive variables, occupancy ratios and coupling terms
+static double Cellule::* const champs_reprise[] = {
+  &Cellule::rho, &Cellule::rho1, &Cellule::u, &Cellule::v, &Cellule::w, &Cellule::p, &Cellule::p1,
+  &Cellule::impx, &Cellule::impy, &Cellule::impz, &Cellule::rhoE,
+  &Cellule::rho0, &Cellule::impx0, &Cellule::impy0, &Cellule::impz0, &Cellule::rhoE0,
+  &Cellule::alpha, &Cellule::alpha0,
+  &Cellule::kappai, &Cellule::kappaj, &Cellule::kappak, &Cellule::kappai0, &Cellule::kappaj0, &Cellule::kappak0,
+  &Cellule::pdtx, &Cellule::pdty, &Cellule::pdtz,
+  &Cellule::phi_x, &Cellule::phi_y, &Cellule::phi_z, &Cellule::phi_v
+};
+const int nb_champs_reprise = sizeof(champs_reprise)/sizeof(champs_reprise[0]); //!< Number of fields of \a champs_reprise
+
+//! Kinematic vectors of \a Particule stored in the checkpoint
+static Vecteur_3 Particule::* const vecteurs_reprise[] = {
+  &Particule::Dx, &Particule::Dxprev, &Particule::Fi, &Particule::Ff, &Particule::Ffprev,
+  &Particule::Mi, &Particule::Mf, &Particule::Mfprev, &Particule::u, &Particule::u_half,
+  &Particule::omega, &Particule::omega_half, &Particule::e, &Particule::eprev
+};
+const int nb_vecteurs_reprise = sizeof(vecteurs_reprise)/sizeof(vecteurs_reprise[0]); //!< Number of vectors of \a vecteurs_reprise
+
+//! \brief Writes the \a n values of \a x in binary
+template<class T> void Ecrit_brut(std::ostream& out, const T* x, const size_t n){
+  if(n>0){
+    out.write(reinterpret_cast<const char*>(x), n*sizeof(T));
+  }
+}
+
+//! \brief Writes the value \a x in binary
+template<class T> void Ecrit_brut(std::ostream& out, const T& x){
+  Ecrit_brut(out,&x,1);
+}
+
+//! \brief Writes the size of \a v then its values in binary
+template<class T> void Ecrit_brut(std::ostream& out, const std::vector<T>& v){
+  const int n = v.size();
+  Ecrit_brut(out,n);
+  Ecrit_brut(out,v.data(),v.size());
+}
+
+//! \brief Writes an affine transformation as its 12 coefficients
+inline void Ecrit_brut(std::ostream& out, const Aff_transformation_3& mvt){
+  double m[12];
+  for(int a=0;a<3;a++){
+    for(int b=0;b<4;b++){
+      m[4*a+b] = CGAL::to_double(mvt.m(a,b));
+    }
+  }
+  Ecrit_brut(out,m,12);
+}
+
+const int taille_entete_serie = 8+3*sizeof(int); //!< Size in bytes of the header of a binary series (see \a Ecrit_entete_serie)
+
+/*!\brief Writes the header of a binary series (resultats/sondes.bin, series.bin, solide_trajectoire.bin).
+  \details 8 characters identifying the file, then the version, the byte order marker \a marqueur_octets and the number of columns, in native byte order (\a taille_entete_serie bytes).
+  \param out file
+  \param magie identifier of the file (8 characters, "CELIA3D" followed by a letter)
+  \param version version of the layout of the file
+  \param nb_colonnes number of doubles of each row (0 if the records have a variable size)
+  \return void
+*/
+inline void Ecrit_entete_serie(std::ostream& out, const char* magie, const int version, const int nb_colonnes){
+  Ecrit_brut(out,magie,8);
+  Ecrit_brut(out,version);
+  Ecrit_brut(out,marqueur_octets);
+  Ecrit_brut(out,nb_colonnes);
+}
+
+/*!\brief Reads the header of a binary series written by \a Ecrit_entete_serie.
+  \param in file, positioned at the start
+  \param magie identifier of the file (output, 8 characters)
+  \param version version of the layout of the file (output)
+  \param nb_colonnes number of doubles of each row (output)
+  \return bool: false if the file is too short, is not a series of CELIA3D or has another byte order
+*/
+inline bool Lit_entete_serie(std::istream& in, char* magie, int& version, int& nb_colonnes){
+  int marqueur = 0;
+  in.read(magie,8);
+  in.read(reinterpret_cast<char*>(&version),sizeof(int));
+  in.read(reinterpret_cast<char*>(&marqueur),sizeof(int));
+  in.read(reinterpret_cast<char*>(&nb_colonnes),sizeof(int));
+  return in && strncmp(magie,"CELIA3D",7)==0 && marqueur==marqueur_octets;
+}
+
+/*!\brief Reading of a checkpoint mapped in memory (POSIX mmap).
+  \details The values are copied from the mapping in the order of the writing. Reading past the end of the file sets \a Lecture_reprise.erreur and gives zeros.
+*/
+class Lecture_reprise
+{
+public:
+  //! \brief Maps the file \a nom in memory
+  Lecture_reprise(const char* nom): erreur(false), fd(-1), debut(NULL), taille(0), position(0) {
+    fd = open(nom,O_RDONLY);
+    struct stat infos;
+    if(fd<0 || fstat(fd,&infos)!=0){
+      erreur = true;
+      return;
+    }
+    taille = infos.st_size;
+    void* carte = mmap(NULL,taille,PROT_READ,MAP_PRIVATE,fd,0);
+    if(carte==MAP_FAILED){
+      erreur = true;
+      return;
+    }
+    debut = static_cast<const char*>(carte);
+    madvise(carte,taille,MADV_SEQUENTIAL);
+  }
+  ~Lecture_reprise(){
+    if(debut!=NULL){
+      munmap(const_cast<char*>(debut),taille);
+    }
+    if(fd>=0){
+      close(fd);
+    }
+  }
+
+  //! \brief Reads \a n values in \a x
+  template<class T> void lit(T* x, const size_t n){
+    if(erreur || position+n*sizeof(T)>taille){
+      erreur = true;
+      memset(x,0,n*sizeof(T));
+      return;
+    }
+    memcpy(x,debut+position,n*sizeof(T));
+    position += n*sizeof(T);
+  }
+
+  //! \brief Reads one value
+  template<class T> T lit(){
+    T x;
+    lit(&x,1);
+    return x;
+  }
+
+  //! \brief Reads the size of \a v then its values
+  template<class T> void lit(std::vector<T>& v){
+    const int n = lit<int>();
+    if(n<0 || position+n*sizeof(T)>taille){
+      erreur = true;
+      v.clear();
+      return;
+    }
+    v.resize(n);
+    lit(v.data(),n);
+  }
+
+  //! \brief Reads an affine transformation written as its 12 coefficients
+  Aff_transformation_3 lit_transformation(){
+    double m[12];
+    lit(m,12);
+    return Aff_transformation_3(m[0],m[1],m[2],m[3],m[4],m[5],m[6],m[7],m[8],m[9],m[10],m[11]);
+  }
+
+  bool complet() const { return position==taille; } //!< True if the whole file has been read
+
+  bool erreur; //!< =true if the file could not be mapped or is too short
+
+private:
+  int fd;              //!< File descriptor
+  const char* debut;   //!< Start of the mapping
+  size_t taille;       //!< Size of the file
+  size_t position;     //!< Position of the next value to read
+};
+
+/*!\brief Writes the checkpoint resultats/reprise<n>.bin of the whole simulation state.
+  \details The file is written under a temporary name then renamed, so that an interrupted writing does not leave a truncated checkpoint. The writing is synchronous: the state of the fluid and of the solid is the one at time \a etat.t.
+  \param n index of the checkpoint (index of the output files written at the same time)
+  \param Fluide fluid
+  \param S solid
+  \param Aitken relaxation of the semi-implicit coupling
+  \param etat time and global baselines
+  \param cumuls pressure accumulators (none if NULL)
+  \return void
+*/
+void Sauvegarde_reprise(const int n, Grille& Fluide, Solide& S, const Relaxation_Aitken& Aitken, const Etat_reprise& etat, const Cumuls_fluide* cumuls){
+  std::ostringstream nom, nom_tmp;
+  nom << "resultats/reprise" << n << ".bin";
+  nom_tmp << nom.str() << ".tmp";
+  std::ofstream out(nom_tmp.str().c_str(),std::ios::out | std::ios::binary);
+  if(!out){
+    std::cout << "Opening of '" << nom_tmp.str() << "' failed" << std::endl;
+    return;
+  }
+  //Header
+  const char magie[8] = "CELIA3D";
+  Ecrit_brut(out,magie,8);
+  Ecrit_brut(out,version_reprise);
+  Ecrit_brut(out,marqueur_octets);
+  const int dimensions[4] = {Nx, Ny, Nz, marge};
+  Ecrit_brut(out,dimensions,4);
+  const int nb_part = S.size();
+  const int nb_liens = S.liens.size();
+  Ecrit_brut(out,nb_part);
+  Ecrit_brut(out,nb_liens);
+  Ecrit_brut(out,etat.t);
+  Ecrit_brut(out,etat.kimp);
+  Ecrit_brut(out,etat.next_timp);
+  Ecrit_brut(out,etat.E0);
+  Ecrit_brut(out,etat.E0S);
+  Ecrit_brut(out,etat.masse);
+  Ecrit_brut(out,etat.volume_initial);
+  Ecrit_brut(out,etat.iteration);
+  Ecrit_brut(out,S.nb_positions);
+
+  //Fluid: one array per field
+  const int nx = Nx+2*marge, ny = Ny+2*marge, nz = Nz+2*marge;
+  std::vector<double> champ(nx*ny*nz);
+  std::vector<int> entiers(nx*ny*nz);
+  std::vector<char> drapeaux(nx*ny*nz);
+  for(int m=0; m<nb_champs_reprise; m++){
+#pragma omp parallel for schedule(static)
+    for(int i=0; i<nx; i++){
+      for(int j=0; j<ny; j++){
+	for(int k=0; k<nz; k++){
+	  champ[k+nz*(j+ny*i)] = Fluide.grille[i][j][k].*champs_reprise[m];
+	}
+      }
+    }
+    Ecrit_brut(out,champ.data(),champ.size());
+  }
+  for(int m=0; m<2; m++){
+#pragma omp parallel for schedule(static)
+    for(int i=0; i<nx; i++){
+      for(int j=0; j<ny; j++){
+	for(int k=0; k<nz; k++){
+	  const Cellule& c = Fluide.grille[i][j][k];
+	  entiers[k+nz*(j+ny*i)] = (m==0) ? c.proche : c.proche1;
+	}
+      }
+    }
+    Ecrit_brut(out,entiers.data(),entiers.size());
+  }
+  for(int i=0; i<nx; i++){
+    for(int j=0; j<ny; j++){
+      for(int k=0; k<nz; k++){
+	drapeaux[k+nz*(j+ny*i)] = Fluide.grille[i][j][k].vide;
+      }
+    }
+  }
+  Ecrit_brut(out,drapeaux.data(),drapeaux.size());
+
+  //Solid: bond topology, then kinematics of the particles
+  Ecrit_brut(out,S.liens_rompus);
+  for(int it=0; it<nb_part; it++){
+    const Particule& P = S.solide[it];
+    for(int m=0; m<nb_vecteurs_reprise; m++){
+      const Vecteur_3& V = P.*vecteurs_reprise[m];
+      const double v[3] = {V[0], V[1], V[2]};
+      Ecrit_brut(out,v,3);
+    }
+    Ecrit_brut(out,P.epsilon);
+    Ecrit_brut(out,&P.rot_t[0][0],9);
+    Ecrit_brut(out,&P.Q_t[0][0],9);
+    Ecrit_brut(out,P.quaternion,4);
+    Ecrit_brut(out,P.mvt_t);
+    Ecrit_brut(out,P.mvt_tprev);
+  }
+  //Cut-cell registry: interface geometry of the triangles at time t
+  std::vector<double> coordonnees;
+  std::vector<int> positions;
+  for(int it=0; it<nb_part; it++){
+    const Particule& P = S.solide[it];
+    const int nb_triangles = P.triangles.size();
+    Ecrit_brut(out,nb_triangles);
+    for(int l=0; l<nb_triangles; l++){
+      coordonnees.clear();
+      for(int p=0; p<P.Points_interface[l].size(); p++){
+	const Point_3& X = P.Points_interface[l][p];
+	coordonnees.push_back(CGAL::to_double(X.x()));
+	coordonnees.push_back(CGAL::to_double(X.y()));
+	coordonnees.push_back(CGAL::to_double(X.z()));
+      }
+      Ecrit_brut(out,coordonnees);
+      coordonnees.clear();
+      for(int p=0; p<P.Triangles_interface[l].size(); p++){
+	for(int s=0; s<3; s++){
+	  const Point_3 X = P.Triangles_interface[l][p].vertex(s);
+	  coordonnees.push_back(CGAL::to_double(X.x()));
+	  coordonnees.push_back(CGAL::to_double(X.y()));
+	  coordonnees.push_back(CGAL::to_double(X.z()));
+	}
+      }
+      Ecrit_brut(out,coordonnees);
+      positions.clear();
+      for(int p=0; p<P.Position_Triangles_interface[l].size(); p++){
+	positions.insert(positions.end(),P.Position_Triangles_interface[l][p].begin(),P.Position_Triangles_interface[l][p].end());
+      }
+      Ecrit_brut(out,positions);
+    }
+  }
+
+  //Semi-implicit coupling
+  Ecrit_brut(out,Aitken.omega);
+  Ecrit_brut(out,Aitken.omega_prev);
+  Ecrit_brut(out,Aitken.correction);
+
+  //Pressure accumulators
+  const int avec_cumuls = (cumuls!=NULL);
+  Ecrit_brut(out,avec_cumuls);
+  if(cumuls!=NULL){
+    Ecrit_brut(out,cumuls->debut);
+    Ecrit_brut(out,cumuls->duree);
+    for(int q=0; q<4; q++){
+      Ecrit_brut(out,cumuls->integrale[q]);
+      Ecrit_brut(out,cumuls->maximum[q]);
+      Ecrit_brut(out,cumuls->minimum[q]);
+    }
+  }
+
+  out.close();
+  if(!out || std::rename(nom_tmp.str().c_str(),nom.str().c_str())!=0){
+    std::cout << "Writing of '" << nom.str() << "' failed" << std::endl;
+  }
+}
+
+/*!\brief Restart from the checkpoint \a nom written by \a Sauvegarde_reprise.
+  \details \a Fluide and \a S must have been initialized from parametres.cpp and maillage.dat (\a Grille.Init and \a Solide.Init): the file is checked against their dimensions, the broken links are broken again in the same order, then the stored state replaces the initial one. The interface geometry is restored as it was computed by \a Grille.Parois_particles at time \a etat.t, which must not be called again.
+  Errors are recorded in resultats/anomalies.dat.
+  \param nom checkpoint file
+  \param Fluide fluid
+  \param S solid
+  \param Aitken relaxation of the semi-implicit coupling
+  \param etat time and global baselines (output)
+  \param cumuls pressure accumulators, continued if they are in the checkpoint (NULL if they are not used)
+  \return bool: true if the state has been restored
+*/
+bool Chargement_reprise(const char* nom, Grille& Fluide, Solide& S, Relaxation_Aitken& Aitken, Etat_reprise& etat, Cumuls_fluide* cumuls){
+  Lecture_reprise in(nom);
+  if(in.erreur){
+    anomalies.Signale(anomalie_lecture_reprise,0.) << nom << " cannot be mapped" << "\n";
+    return false;
+  }
+  //Header
+  char magie[8];
+  in.lit(magie,8);
+  const int version = in.lit<int>();
+  const int marqueur = in.lit<int>();
+  if(in.erreur || strncmp(magie,"CELIA3D",8)!=0 || marqueur!=marqueur_octets){
+    anomalies.Signale(anomalie_lecture_reprise,0.) << nom << " is not a checkpoint of this machine" << "\n";
+    return false;
+  }
+  if(version!=version_reprise){
+    anomalies.Signale(anomalie_lecture_reprise,0.) << nom << " version " << version << " instead of " << version_reprise << "\n";
+    return false;
+  }
+  int dimensions[4];
+  in.lit(dimensions,4);
+  const int nb_part = in.lit<int>();
+  const int nb_liens = in.lit<int>();
+  if(dimensions[0]!=Nx || dimensions[1]!=Ny || dimensions[2]!=Nz || dimensions[3]!=marge || nb_part!=S.size() || nb_liens!=S.liens.size()){
+    anomalies.Signale(anomalie_lecture_reprise,0.) << nom << " grid " << dimensions[0] << "x" << dimensions[1] << "x" << dimensions[2] << " marge " << dimensions[3] << " particles " << nb_part << " links " << nb_liens << " does not match the parameters" << "\n";
+    return false;
+  }
+  etat.t = in.lit<double>();
+  etat.kimp = in.lit<int>();
+  etat.next_timp = in.lit<double>();
+  etat.E0 = in.lit<double>();
+  etat.E0S = in.lit<double>();
+  etat.masse = in.lit<double>();
+  etat.volume_initial = in.lit<double>();
+  etat.iteration = in.lit<int>();
+  const int nb_positions = in.lit<int>();
+
+  //Fluid
+  const int nx = Nx+2*marge, ny = Ny+2*marge, nz = Nz+2*marge;
+  std::vector<double> champ(nx*ny*nz);
+  std::vector<int> entiers(nx*ny*nz);
+  std::vector<char> drapeaux(nx*ny*nz);
+  for(int m=0; m<nb_champs_reprise; m++){
+    in.lit(champ.data(),champ.size());
+#pragma omp parallel for schedule(static)
+    for(int i=0; i<nx; i++){
+      for(int j=0; j<ny; j++){
+	for(int k=0; k<nz; k++){
+	  Fluide.grille[i][j][k].*champs_reprise[m] = champ[k+nz*(j+ny*i)];
+	}
+      }
+    }
+  }
+  for(int m=0; m<2; m++){
+    in.lit(entiers.data(),entiers.size());
+#pragma omp parallel for schedule(static)
+    for(int i=0; i<nx; i++){
+      for(int j=0; j<ny; j++){
+	for(int k=0; k<nz; k++){
+	  Cellule& c = Fluide.grille[i][j][k];
+	  (m==0 ? c.proche : c.proche1) = entiers[k+nz*(j+ny*i)];
+	}
+      }
+    }
+  }
+  in.lit(drapeaux.data(),drapeaux.size());
+  for(int i=0; i<nx; i++){
+    for(int j=0; j<ny; j++){
+      for(int k=0; k<nz; k++){
+	Fluide.grille[i][j][k].vide = drapeaux[k+nz*(j+ny*i)];
+      }
+    }
+  }
+
+  //Solid: the links are broken again in the order of the breaks
+  std::vector<int> liens_rompus;
+  in.lit(liens_rompus);
+  for(int r=0; r<liens_rompus.size(); r++){
+    const int l = liens_rompus[r];
+    if(l<0 || l>=nb_liens || !S.liens[l].actif){
+      anomalies.Signale(anomalie_lecture_reprise,0.) << nom << " broken link " << l << "\n";
+      return false;
+    }
+    S.Rupture_lien(l);
+  }
+  S.ruptures.clear();
+  for(int it=0; it<nb_part; it++){
+    Particule& P = S.solide[it];
+    for(int m=0; m<nb_vecteurs_reprise; m++){
+      double v[3];
+      in.lit(v,3);
+      P.*vecteurs_reprise[m] = Vecteur_3(v[0],v[1],v[2]);
+    }
+    P.epsilon = in.lit<double>();
+    in.lit(&P.rot_t[0][0],9);
+    in.lit(&P.Q_t[0][0],9);
+    in.lit(P.quaternion,4);
+    P.mvt_t = in.lit_transformation();
+    P.mvt_tprev = in.lit_transformation();
+  }
+  //Triangles of the particles at time t, then their interface geometry
+  S.update_triangles();
+  std::vector<double> coordonnees;
+  std::vector<int> positions;
+  for(int it=0; it<nb_part && !in.erreur; it++){
+    Particule& P = S.solide[it];
+    const int nb_triangles = in.lit<int>();
+    if(nb_triangles!=P.triangles.size()){
+      anomalies.Signale(anomalie_lecture_reprise,0.) << nom << " particle " << it << " triangles " << nb_triangles << "\n";
+      return false;
+    }
+    for(int l=0; l<nb_triangles; l++){
+      in.lit(coordonnees);
+      P.Points_interface[l].clear();
+      for(int p=0; p+2<coordonnees.size(); p+=3){
+	P.Points_interface[l].push_back(Point_3(coordonnees[p],coordonnees[p+1],coordonnees[p+2]));
+      }
+      in.lit(coordonnees);
+      P.Triangles_interface[l].clear();
+      for(int p=0; p+8<coordonnees.size(); p+=9){
+	P.Triangles_interface[l].push_back(Triangle_3(Point_3(coordonnees[p],coordonnees[p+1],coordonnees[p+2]),
+						      Point_3(coordonnees[p+3],coordonnees[p+4],coordonnees[p+5]),
+						      Point_3(coordonnees[p+6],coordonnees[p+7],coordonnees[p+8])));
+      }
+      in.lit(positions);
+      P.Position_Triangles_interface[l].clear();
+      for(int p=0; p+2<positions.size(); p+=3){
+	P.Position_Triangles_interface[l].push_back(std::vector<int>(positions.begin()+p,positions.begin()+p+3));
+      }
+    }
+  }
+  S.nb_positions = nb_positions;
+
+  //Semi-implicit coupling
+  Aitken.omega = in.lit<double>();
+  Aitken.omega_prev = in.lit<double>();
+  in.lit(Aitken.correction);
+
+  //Pressure accumulators, ignored if they are not used any more
+  if(in.lit<int>()){
+    Cumuls_fluide lus;
+    lus.debut = in.lit<double>();
+    lus.duree = in.lit<double>();
+    for(int q=0; q<4; q++){
+      in.lit(lus.integrale[q]);
+      in.lit(lus.maximum[q]);
+      in.lit(lus.minimum[q]);
+    }
+    if(cumuls!=NULL && lus.integrale[0].size()==Nx*Ny*Nz){
+      lus.dx = cumuls->dx; lus.dy = cumuls->dy; lus.dz = cumuls->dz;
+      *cumuls = lus;
+    }
+  }
+  else if(cumuls!=NULL){
+    cumuls->debut = etat.t;
+  }
+
+  if(in.erreur || !in.complet()){
+    anomalies.Signale(anomalie_lecture_reprise,0.) << nom << " truncated or too long" << "\n";
+    return false;
+  }
+  return true;
+}
+
+/*!\brief Removes from a time series the rows written after the checkpoint time \a t by the interrupted run.
+  \details The rows are assumed in increasing time order, the time being the first value of the row. The file is truncated in place (it may already be opened in append mode), at the first row whose time is after \a t (\a inclus true) or not before \a t (\a inclus false), with a relative tolerance of 1e-6 for the times written with few digits. Text files: lines not starting with a number (header) are kept. Binary files: header read by \a Lit_entete_serie followed by the rows of doubles, as resultats/sondes.bin. Nothing is done if the file does not exist or if its header is not recognized.
+  \param nom file
+  \param t time of the checkpoint
+  \param inclus true to keep the rows at time \a t (rows that the restarted run does not write again)
+  \param binaire true for a binary file
+  \return void
+*/
+void Tronque_serie(const char* nom, const double t, const bool inclus, const bool binaire){
+  std::ifstream in(nom,std::ios::in|std::ios::binary);
+  if(!in){
+    return;
+  }
+  const double tolerance = 1.e-6*std::abs(t);
+  long fin = 0;
+  bool apres = false;
+  if(binaire){
+    char magie[8];
+    int version, nb_colonnes;
+    if(!Lit_entete_serie(in,magie,version,nb_colonnes)){
+      return;
+    }
+    std::vector<double> ligne(std::max(nb_colonnes,1));
+    fin = taille_entete_serie;
+    while(in.read(reinterpret_cast<char*>(ligne.data()),ligne.size()*sizeof(double))){
+      if(inclus ? ligne[0]>t+tolerance : ligne[0]>=t-tolerance){
+	apres = true;
+	break;
+      }
+      fin += ligne.size()*sizeof(double);
+    }
+  }
+  else{
+    std::string ligne;
+    while(std::getline(in,ligne)){
+      std::istringstream valeurs(ligne);
+      double tl;
+      if((valeurs >> tl) && (inclus ? tl>t+tolerance : tl>=t-tolerance)){
+	apres = true;
+	break;
+      }
+      fin += ligne.size()+1;
+    }
+  }
+  in.close();
+  if(apres && truncate(nom,fin)!=0){
+    std::cout << "Truncation of '" << nom << "' at t=" << t << " failed" << std::endl;
+  }
+}
+
+/*!\brief Removes from the file \a nom written by \a Trajectoire_solide the records written after the checkpoint time \a t by the interrupted run.
+  \details Each record after the header (\a Lit_entete_serie) holds the index of the output, its time, its type, the number of vertices, then their coordinates in double precision (key frame) or single precision (differences). The file is truncated in place at the first record whose time is after \a t (with the tolerance of \a Tronque_serie) or which is incomplete. The restarted run begins with a key frame. Nothing is done if the file does not exist or if its header is not recognized.
+  \param nom file
+  \param t time of the checkpoint
+  \return void
+*/
+void Tronque_trajectoire(const char* nom, const double t){
+  std::ifstream in(nom,std::ios::in|std::ios::binary);
+  char magie[8];
+  int version, nb_colonnes;
+  if(!in || !Lit_entete_serie(in,magie,version,nb_colonnes)){
+    return;
+  }
+  in.seekg(0,std::ios::end);
+  const long taille = in.tellg();
+  const double tolerance = 1.e-6*std::abs(t);
+  long fin = taille_entete_serie;
+  while(fin<taille){
+    int n, cle, nb_sommets;
+    double tr;
+    in.seekg(fin);
+    in.read(reinterpret_cast<char*>(&n),sizeof(int));
+    in.read(reinterpret_cast<char*>(&tr),sizeof(double));
+    in.read(reinterpret_cast<char*>(&cle),sizeof(int));
+    in.read(reinterpret_cast<char*>(&nb_sommets),sizeof(int));
+    const long suivant = fin+3*sizeof(int)+sizeof(double)+3L*nb_sommets*((cle==0) ? sizeof(double) : sizeof(float));
+    if(!in || tr>t+tolerance || suivant>taille){
+      break;
+    }
+    fin = suivant;
+  }
+  in.close();
+  if(fin<taille && truncate(nom,fin)!=0){
+    std::cout << "Truncation of '" << nom << "' at t=" << t << " failed" << std::endl;
+  }
+}
+
+#endif
@@ -0,0 +1,141 @@
+//Copyright 2017 Laurent Monasse
+
+/*
+  This file is part of CELIA3D.
+
+  CELIA3D is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  CELIA3D is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with CELIA3D.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+   \file
+   \authors Laurent Monasse and Maria Adela Puscas
+   \brief Time series of scalars (one row per time-step), kept in memory and written by blocks.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include "parametres.hpp"
+#include "reprise.hpp"
+
+#ifndef SERIES_HPP
+#define SERIES_HPP
+
+/*!\brief Time series of scalars, one row per time-step.
+
+The rows are kept in memory by column and written in one block every \a pas_series rows, by \a Series_temporelles.Vide() and by the destructor, so that the files are not flushed at each time-step. Formats (\a Format_series):
+- \a series_texte: values separated by spaces, one row per line, without header (format of energie.dat);
+- \a series_csv: header line with the names of the columns, then values separated by commas;
+- \a series_binaire: header of \a Ecrit_entete_serie ("CELIA3DR", version 1, number of columns), then the rows of doubles; the names of the columns are written in a file with extension .txt.
+*/
+class Series_temporelles
+{
+public:
+  /*!\brief Opens the file \a nom of the series whose columns are \a noms.
+    \param nom file
+    \param format format of the file (\a Format_series)
+    \param noms names of the columns
+    \param ajout true to append the rows to the file (restart)
+  */
+  Series_temporelles(const char* nom, const int format, const std::vector<std::string>& noms, const bool ajout): format(format), noms(noms), colonnes(noms.size()) {
+    std::ios::openmode mode = std::ios::out;
+    if(ajout){
+      mode |= std::ios::app;
+    }
+    if(format==series_binaire){
+      mode |= std::ios::binary;
+    }
+    fichier.open(nom,mode);
+    if(!fichier){
+      std::cout << "Opening of '" << nom << "' failed" << std::endl;
+      return;
+    }
+    fichier << std::setprecision(precision_series);
+    const bool vide = (!ajout || fichier.tellp()==0);
+    if(format==series_csv && vide){
+      for(int c=0; c<noms.size(); c++){
+	fichier << noms[c] << ((c+1<noms.size()) ? "," : "\n");
+      }
+    }
+    else if(format==series_binaire){
+      if(vide){
+	Ecrit_entete_serie(fichier,"CELIA3DR",1,noms.size());
+      }
+      std::ofstream txt((std::string(nom)+".txt").c_str(),std::ios::out);
+      for(int c=0; c<noms.size(); c++){
+	txt << c << " " << noms[c] << "\n";
+      }
+    }
+  }
+  ~Series_temporelles(){ Vide(); }
+
+  //! \brief Adds a row: one value per column
+  void Ajoute(const double* valeurs){
+    for(int c=0; c<colonnes.size(); c++){
+      colonnes[c].push_back(valeurs[c]);
+    }
+    if(colonnes[0].size()>=pas_series){
+      Vide();
+    }
+  }
+
+  //! \brief Writes the rows kept in memory and flushes the file
+  void Vide(){
+    if(colonnes.empty() || colonnes[0].empty() || !fichier.is_open()){
+      return;
+    }
+    const int nb_lignes = colonnes[0].size();
+    const int nb_colonnes = colonnes.size();
+    if(format==series_binaire){
+      std::vector<double> lignes(nb_lignes*nb_colonnes);
+      for(int l=0; l<nb_lignes; l++){
+	for(int c=0; c<nb_colonnes; c++){
+	  lignes[l*nb_colonnes+c] = colonnes[c][l];
+	}
+      }
+      fichier.write(reinterpret_cast<const char*>(lignes.data()),lignes.size()*sizeof(double));
+    }
+    else{
+      const char separateur = (format==series_csv) ? ',' : ' ';
+      std::ostringstream bloc;
+      bloc << std::setprecision(precision_series);
+      for(int l=0; l<nb_lignes; l++){
+	for(int c=0; c<nb_colonnes; c++){
+	  bloc << colonnes[c][l];
+	  if(c+1<nb_colonnes){
+	    bloc << separateur;
+	  }
+	}
+	bloc << "\n";
+      }
+      const std::string s = bloc.str();
+      fichier.write(s.data(),s.size());
+    }
+    fichier.flush();
+    for(int c=0; c<nb_colonnes; c++){
+      colonnes[c].clear();
+    }
+  }
+
+private:
+  int format;                                   //!< Format of the file
+  std::vector<std::string> noms;                //!< Names of the columns
+  std::vector< std::vector<double> > colonnes;  //!< Rows not written yet, by column
+  std::ofstream fichier;                        //!< Output file
+};
+
+#endif
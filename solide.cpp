@@ -23,9 +23,15 @@
  *  \brief Definition of the functions in class Solide. 
  * Specific coupling procedures are preceded by a "warning" sign.
  */
+#include "journal.hpp"
+#include "sorties.hpp"
 #include "solide.hpp"
 #include "intersections.hpp"
+#include "reprise.hpp"
 #include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <map>
 #ifndef SOLIDE_CPP
 #define SOLIDE_CPP
 
@@ -778,6 +784,15 @@ Particule & Particule:: operator=(const Particule &P){
   omega_half = P.omega_half;
   e = P.e;
   eprev= P.eprev;
+  for(int i=0; i<3;i++){
+    for(int j=0; j<3;j++){
+      rot_t[i][j] = P.rot_t[i][j];
+      Q_t[i][j] = P.Q_t[i][j];
+    }
+  }
+  for(int i=0; i<4;i++){
+    quaternion[i] = P.quaternion[i];
+  }
   mvt_t = P.mvt_t;
   mvt_tprev = P.mvt_tprev;
 	
@@ -936,26 +951,9 @@ void Particule::solve_position(double dt){
       cout << "Erreur rotation rotref " << vectrot1 << " " << vectrot2 << " " << vectrot3 << endl;
       //getchar();
     }
-    //Computation of the total rotation matrix from the inertial frame to the current frame at time t and storage of eprev
+    //Total rotation matrix from the inertial frame to the current frame at time t and storage of eprev
     double Q[3][3];
-    double e0 = sqrt(1.-CGAL::to_double(e.squared_length()));
-    //Recover the rotation matrix
-    rot[0][0] = 1.-2.*CGAL::to_double(e.operator[](1)*e.operator[](1)+e.operator[](2)*e.operator[](2));
-    rot[0][1] = 2.*CGAL::to_double(-e0*e.operator[](2)+e.operator[](0)*e.operator[](1));
-    rot[0][2] = 2.*CGAL::to_double(e0*e.operator[](1)+e.operator[](0)*e.operator[](2));
-    rot[1][0] = 2.*CGAL::to_double(e0*e.operator[](2)+e.operator[](1)*e.operator[](0));
-    rot[1][1] = 1.-2.*CGAL::to_double(e.operator[](0)*e.operator[](0)+e.operator[](2)*e.operator[](2));
-    rot[1][2] = 2.*CGAL::to_double(-e0*e.operator[](0)+e.operator[](1)*e.operator[](2));
-    rot[2][0] = 2.*CGAL::to_double(-e0*e.operator[](1)+e.operator[](2)*e.operator[](0));
-    rot[2][1] = 2.*CGAL::to_double(e0*e.operator[](0)+e.operator[](2)*e.operator[](1));
-    rot[2][2] = 1.-2.*CGAL::to_double(e.operator[](0)*e.operator[](0)+e.operator[](1)*e.operator[](1));
-    for(int i=0;i<3;i++){
-      for(int j=0;j<3;j++){
-	Q[i][j] = rot[i][0]*rotref[0][j];
-	Q[i][j] += rot[i][1]*rotref[1][j];
-	Q[i][j] += rot[i][2]*rotref[2][j];
-      }
-    }    
+    memcpy(Q,Q_t,sizeof(Q));
     eprev = e;
     //Recover the global e from omega
     double Omega[3];
@@ -1152,9 +1150,38 @@ void Particule::solve_position(double dt){
   //Update the particle movement
   mvt_tprev = mvt_t;
   Aff_transformation_3 rotation(rot[0][0],rot[0][1],rot[0][2],rot[1][0],rot[1][1],rot[1][2],rot[2][0],rot[2][1],rot[2][2]);
-  Aff_transformation_3 translation(CGAL::TRANSLATION,Vector_3(Point_3(0.,0.,0.),x0)+Dx);
+  Aff_transformation_3 translation(CGAL::TRANSLATION,Vector_3(Point_3(0.,0.,0.),x0)+Dx.vector_3());
   Aff_transformation_3 translation_inv(CGAL::TRANSLATION,Vector_3(x0,Point_3(0.,0.,0.)));
   mvt_t = translation*(rotation*translation_inv);
+  memcpy(rot_t,rot,sizeof(rot));
+  Mise_a_jour_rotation();
+}
+
+/*!\brief Update of the rotation of the particle at time t.
+ * \details Computes \a Particule.quaternion and \a Particule.Q_t from the rotation vector \a Particule.e. Called once per update of \a Particule.e, so that \a Particule.solve_position, \a Particule.solve_vitesse and \a Particule.Energie_cinetique do not rebuild the rotation.
+ * \return void
+ */
+void Particule::Mise_a_jour_rotation(){
+  double e0 = sqrt(1.-e.squared_length());
+  quaternion[0] = e0;
+  quaternion[1] = e[0];
+  quaternion[2] = e[1];
+  quaternion[3] = e[2];
+  double rot[3][3];
+  rot[0][0] = 1.-2.*(e[1]*e[1]+e[2]*e[2]);
+  rot[0][1] = 2.*(-e0*e[2]+e[0]*e[1]);
+  rot[0][2] = 2.*(e0*e[1]+e[0]*e[2]);
+  rot[1][0] = 2.*(e0*e[2]+e[1]*e[0]);
+  rot[1][1] = 1.-2.*(e[0]*e[0]+e[2]*e[2]);
+  rot[1][2] = 2.*(-e0*e[0]+e[1]*e[2]);
+  rot[2][0] = 2.*(-e0*e[1]+e[2]*e[0]);
+  rot[2][1] = 2.*(e0*e[0]+e[2]*e[1]);
+  rot[2][2] = 1.-2.*(e[0]*e[0]+e[1]*e[1]);
+  for(int i=0;i<3;i++){
+    for(int j=0;j<3;j++){
+      Q_t[i][j] = rot[i][0]*rotref[0][j]+rot[i][1]*rotref[1][j]+rot[i][2]*rotref[2][j];
+    }
+  }
 }
 
 /*!
@@ -1177,34 +1204,9 @@ void Particule::solve_vitesse(double dt){
       u = Vector_3(0.,0.,0.);
     }
     
-    //Compute the total rotation matrix from the inertial frame to the current frame at time t
+    //Total rotation matrix from the inertial frame to the current frame at time t
     double Q[3][3];
-    double e0 = sqrt(1.-CGAL::to_double(e.squared_length()));
-    //Recover the rotation matrix
-    double rot[3][3];
-    rot[0][0] = 1.-2.*CGAL::to_double(e.operator[](1)*e.operator[](1)+e.operator[](2)*e.operator[](2));
-    rot[0][1] = 2.*CGAL::to_double(-e0*e.operator[](2)+e.operator[](0)*e.operator[](1));
-    rot[0][2] = 2.*CGAL::to_double(e0*e.operator[](1)+e.operator[](0)*e.operator[](2));
-    rot[1][0] = 2.*CGAL::to_double(e0*e.operator[](2)+e.operator[](1)*e.operator[](0));
-    rot[1][1] = 1.-2.*CGAL::to_double(e.operator[](0)*e.operator[](0)+e.operator[](2)*e.operator[](2));
-    rot[1][2] = 2.*CGAL::to_double(-e0*e.operator[](0)+e.operator[](1)*e.operator[](2));
-    rot[2][0] = 2.*CGAL::to_double(-e0*e.operator[](1)+e.operator[](2)*e.operator[](0));
-    rot[2][1] = 2.*CGAL::to_double(e0*e.operator[](0)+e.operator[](2)*e.operator[](1));
-    rot[2][2] = 1.-2.*CGAL::to_double(e.operator[](0)*e.operator[](0)+e.operator[](1)*e.operator[](1));
-    for(int i=0;i<3;i++){
-      for(int j=0;j<3;j++){
-	Q[i][j] = rot[i][0]*rotref[0][j];
-	Q[i][j] += rot[i][1]*rotref[1][j];
-	Q[i][j] += rot[i][2]*rotref[2][j];
-      }
-    }    
-    for(int i=0;i<3;i++){
-      for(int j=0;j<3;j++){
-	Q[i][j] = rot[i][0]*rotref[0][j];
-	Q[i][j] += rot[i][1]*rotref[1][j];
-	Q[i][j] += rot[i][2]*rotref[2][j];
-      }
-    }    
+    memcpy(Q,Q_t,sizeof(Q));
     //Recover Zn+1/2 from omega
     double Omega[3];
     Omega[0] = Omega[1] = Omega[2] = 0.;
@@ -1335,9 +1337,9 @@ double Particule::volume(){
  */
 Vector_3 Particule::vitesse_parois(const Point_3& X_f){
 		
-  Vector_3 V_f = u_half + cross_product(omega_half, Vector_3(x0 + Dx,X_f));
+  Vecteur_3 V_f = u_half + cross_product(omega_half, Vecteur_3(Vector_3(x0,X_f)) - Dx);
 
-  return V_f;
+  return V_f.vector_3();
 }	
 /*!\brief Velocity at the interface elements center at time t-dt.
  * \f$ V_f = V_I + \Omega_{rot} \wedge \left( X_f - X_I \right). \f$ \n
@@ -1348,9 +1350,9 @@ Vector_3 Particule::vitesse_parois(const Point_3& X_f){
  */
 Vector_3 Particule::vitesse_parois_prev(const Point_3& X_f){
 	
-  Vector_3 V_f = u_half + cross_product(omega_half, Vector_3(x0 + Dxprev,X_f));
+  Vecteur_3 V_f = u_half + cross_product(omega_half, Vecteur_3(Vector_3(x0,X_f)) - Dxprev);
 	
-  return V_f;
+  return V_f.vector_3();
 }	
 
 /*!\brief Computation of projection integrals.
@@ -1710,10 +1712,77 @@ void Particule::Volume_libre(){
   }
 }
 
+/*!\brief Compute the kinetic energy of the particle.
+ *\return double
+ */
+double Particule::Energie_cinetique(){
+  double E = 0.;
+  double u2 = u.squared_length();
+  E += 1./2.*m*u2;
+  //Compute -1/2*tr(D j(Q^T omega)) = 1/2*(I1*Omega1^2+I2*Omega2^2+I3*Omega3^2)
+  double Omega[3];
+  Omega[0] = Omega[1] = Omega[2] = 0.;
+  for(int j=0;j<3;j++){
+    for(int k=0;k<3;k++){
+      Omega[j] += omega[k]*Q_t[k][j];
+    }
+  }
+  E += 1./2.*(I[0]*Omega[0]*Omega[0]+I[1]*Omega[1]*Omega[1]+I[2]*Omega[2]*Omega[2]);
+  return E;
+}
+
+/*!\brief Default constructor. 
+ */
+Lien::Lien(){
+  i = j = fi = fj = -1;
+  actif = false;
+  S = D0 = alpha = alphan = alphas = alphat = 0.;
+}
+
+/*!\brief Constructor overload.
+ *\param P1 first particle
+ *\param i1 index of the first particle
+ *\param f1 index of the common face in the first particle
+ *\param P2 second particle
+ *\param i2 index of the second particle
+ *\param f2 index of the common face in the second particle
+ */
+Lien::Lien(const Particule& P1, int i1, int f1, const Particule& P2, int i2, int f2){
+  i = i1;
+  fi = f1;
+  j = i2;
+  fj = f2;
+  actif = true;
+  const Face& F = P1.faces[f1];
+  S = F.S;
+  D0 = F.D0;
+  normale = F.normale;
+  s = F.s;
+  t = F.t;
+  X0iX0j = Vector_3(P1.x0,P2.x0);
+  XCi = Vector_3(P1.x0,F.centre);
+  XCj = Vector_3(P2.x0,F.centre);
+  alpha = sqrt(XCi.squared_length())/D0;
+  //Area vectors of the face, computed from the vertices of each side
+  for(int k=1;k<F.vertex.size()-1;k++){
+    Sni += 1./2.*cross_product(Vecteur_3(Vector_3(F.vertex[0].pos,F.vertex[k].pos)),Vecteur_3(Vector_3(F.vertex[0].pos,F.vertex[k+1].pos)));
+  }
+  const Face& G = P2.faces[f2];
+  for(int k=1;k<G.vertex.size()-1;k++){
+    Snj += 1./2.*cross_product(Vecteur_3(Vector_3(G.vertex[0].pos,G.vertex[k].pos)),Vecteur_3(Vector_3(G.vertex[0].pos,G.vertex[k+1].pos)));
+  }
+  //Flexion/torsion stiffnesses
+  double kappa = 1.;
+  alphan = (2.+2.*nu-kappa)*E/4./(1.+nu)/S*(F.Is+F.It);
+  alphas = E/4./(1.+nu)/S*((2.+2.*nu+kappa)*F.Is-(2.+2.*nu-kappa)*F.It);
+  alphat = E/4./(1.+nu)/S*((2.+2.*nu+kappa)*F.It-(2.+2.*nu-kappa)*F.Is);
+}
+
 /*!\brief Default constructor. 
  */
 Solide::Solide(){
-	
+  nb_positions = 0;
+  nb_ruptures = 0;
 }
 
 /*!\brief Constructor overload.
@@ -1723,6 +1792,9 @@ Solide::Solide(std::vector<Particule> & Part){
   for(int i=0; i<Part.size(); i++){
     solide.push_back(Part[i]);
   }
+  nb_positions = 0;
+  nb_ruptures = 0;
+  Init_liens();
 }
 /*!\brief Destructor.
  */ 
@@ -1740,6 +1812,17 @@ Solide & Solide:: operator=(const Solide &S){
   for(int i=0; i<S.solide.size(); i++){
     solide[i]= S.solide[i];
   }
+  liens = S.liens;
+  liens_particule = S.liens_particule;
+  sommets = S.sommets;
+  particules_sommets = S.particules_sommets;
+  coordonnees_sommets = S.coordonnees_sommets;
+  positions_sommets = S.positions_sommets;
+  ruptures = S.ruptures;
+  nb_positions = S.nb_positions;
+  nb_ruptures = S.nb_ruptures;
+  liens_rompus = S.liens_rompus;
+  return *this;
 }
 
 /*!
@@ -1889,7 +1972,14 @@ void Solide::Init(const char* s){
     solide[i].Inertie();
     solide[i].mvt_t = Aff_transformation_3(1,0,0,0,1,0,0,0,1);
     solide[i].mvt_tprev = Aff_transformation_3(1,0,0,0,1,0,0,0,1);
+    for(int k=0;k<3;k++){
+      for(int l=0;l<3;l++){
+	solide[i].rot_t[k][l] = (k==l) ? 1. : 0.;
+      }
+    }
+    solide[i].Mise_a_jour_rotation();
   }
+  Init_liens();
 
   //In the case of restart
   if(rep){
@@ -1971,11 +2061,13 @@ void Solide::Init(const char* s){
       rot[2][1] = 2.*CGAL::to_double(e0*solide[i].e.operator[](0)+solide[i].e.operator[](2)*solide[i].e.operator[](1));
       rot[2][2] = 1.-2.*CGAL::to_double(solide[i].e.operator[](0)*solide[i].e.operator[](0)+solide[i].e.operator[](1)*solide[i].e.operator[](1));
       Aff_transformation_3 rotation(rot[0][0],rot[0][1],rot[0][2],rot[1][0],rot[1][1],rot[1][2],rot[2][0],rot[2][1],rot[2][2]);
-      Aff_transformation_3 translation(CGAL::TRANSLATION,Vector_3(Point_3(0.,0.,0.),solide[i].x0)+solide[i].Dx);
+      Aff_transformation_3 translation(CGAL::TRANSLATION,Vector_3(Point_3(0.,0.,0.),solide[i].x0)+solide[i].Dx.vector_3());
 
       Aff_transformation_3 translation_inv(CGAL::TRANSLATION,Vector_3(solide[i].x0,Point_3(0.,0.,0.)));
       solide[i].mvt_tprev = solide[i].mvt_t;
       solide[i].mvt_t = translation*(rotation*translation_inv);
+      memcpy(solide[i].rot_t,rot,sizeof(rot));
+      solide[i].Mise_a_jour_rotation();
     }
     update_triangles();
   }
@@ -1983,15 +2075,47 @@ void Solide::Init(const char* s){
 }
 
 /*!\brief Time-integration of the solid position.
+ *\details With sub-cycles (\a n_sub > 1), the solid advances \a n_sub steps of \a dt/n_sub (\a Particule.solve_position, \a Solide.Forces_internes and \a Particule.solve_vitesse) with frozen fluid forces \a Particule.Ff and \a Particule.Mf. The fluid/solid interface is only updated at the end, and the positions at time t-dt (\a Particule.Dxprev, \a Particule.eprev, \a Particule.mvt_tprev) are those of the beginning of the fluid time-step. The last velocity update must be done by \a Solide.Solve_vitesse(dt/n_sub).
  *\param dt Time-step
+ *\param n_sub Number of sub-cycles
+ *\warning The loops over the particles build lazy exact objects (\a Particule.mvt_t, bounding boxes from \a Particule.triangles) and run in parallel only with -DCELIA3D_SWAP_PARALLELE (see \a Grille.Swap_2d).
  *\return void
  */
-void Solide::Solve_position(double dt){
-  for(int i=0;i<size();i++){
-    solide[i].solve_position(dt);
+void Solide::Solve_position(double dt, const int n_sub){
+  nb_positions++;
+  ruptures.clear();
+  const double dt_sub = dt/n_sub;
+  std::vector<Vecteur_3> Dxprev(size()), eprev(size());
+  std::vector<Aff_transformation_3> mvt_tprev(size());
+  for(int s=0;s<n_sub;s++){
+    if(s>0){
+      Forces_internes();
+      Solve_vitesse(dt_sub);
+    }
+#ifdef CELIA3D_SWAP_PARALLELE
+#pragma omp parallel for schedule(static)
+#endif
+    for(int i=0;i<size();i++){
+      solide[i].solve_position(dt_sub);
+      if(s==0){
+	Dxprev[i] = solide[i].Dxprev;
+	eprev[i] = solide[i].eprev;
+	mvt_tprev[i] = solide[i].mvt_tprev;
+      }
+    }
+    breaking_criterion();
+  }
+  if(n_sub>1){
+    for(int i=0;i<size();i++){
+      solide[i].Dxprev = Dxprev[i];
+      solide[i].eprev = eprev[i];
+      solide[i].mvt_tprev = mvt_tprev[i];
+    }
   }
-  breaking_criterion();
   update_triangles();
+#ifdef CELIA3D_SWAP_PARALLELE
+#pragma omp parallel for schedule(static)
+#endif
   for(int i=0;i<size();i++){
     for(std::vector<Triangle_3>::iterator it=solide[i].triangles.begin();it!=solide[i].triangles.end();it++){
       for(int k=0;k<3;k++){
@@ -2008,72 +2132,174 @@ void Solide::Solve_position(double dt){
  *\brief Calcul de la vitesse du solide.
  *\param dt pas de temps
  *\warning <b> Proc&eacute;dure sp&eacute;cifique au solide! </b>
+ *\warning The particles are processed in parallel only with -DCELIA3D_SWAP_PARALLELE: \a Particule.solve_vitesse builds lazy exact vectors.
  *\return void
  */
 void Solide::Solve_vitesse(double dt){
+#ifdef CELIA3D_SWAP_PARALLELE
+#pragma omp parallel for schedule(static)
+#endif
   for(int i=0;i<size();i++){
     solide[i].solve_vitesse(dt);
   }
 }
 
-/*!\brief Computation of internal forces. 
+/*!\brief Build the list of links between particles.
+ *\details Each pair of particles sharing a face with \a Face.voisin >= 0 gives one \a Lien. The links of each particle (\a Solide.liens_particule) and the positions of each vertex in the particle faces (\a Solide.sommets) are also built.
  *\return void
  */
-void Solide::Forces_internes(){
-  //Initialization
+void Solide::Init_liens(){
+  liens.clear();
   for(int i=0;i<size();i++){
-    solide[i].Fi = Vector_3(0.,0.,0.);
-    solide[i].Mi = Vector_3(0.,0.,0.);
+    for(int fi=0;fi<solide[i].faces.size();fi++){
+      int j = solide[i].faces[fi].voisin;
+      if(j>i){
+	int fj = -1;
+	for(int f=0;f<solide[j].faces.size() && fj<0;f++){
+	  if(solide[j].faces[f].voisin == i){
+	    fj = f;
+	  }
+	}
+	if(fj<0){
+	  cout << "Link between particles " << i << " and " << j << " is not reciprocal" << endl;
+	} else {
+	  liens.push_back(Lien(solide[i],i,fi,solide[j],j,fj));
+	}
+      }
+    }
   }
-  //Computation of the volumetric deformation epsilon of each particle
+  liens_particule.assign(size(),std::vector<int>());
+  for(int l=0;l<liens.size();l++){
+    liens_particule[liens[l].i].push_back(l);
+    liens_particule[liens[l].j].push_back(l);
+  }
+  sommets.clear();
   for(int i=0;i<size();i++){
-    solide[i].Volume_libre();
-    solide[i].epsilon = 0.;
-    for(int j=0;j<solide[i].faces.size();j++){
-      if(solide[i].faces[j].voisin>=0){
-	int part = solide[i].faces[j].voisin;
-	Vector_3 Sn = Vector_3(0.,0.,0.);
-	for(int k=1;k<solide[i].faces[j].size()-1;k++){
-	  Sn = Sn + 1./2.*cross_product(Vector_3(solide[i].faces[j].vertex[0].pos,solide[i].faces[j].vertex[k].pos),Vector_3(solide[i].faces[j].vertex[0].pos,solide[i].faces[j].vertex[k+1].pos));
+    for(int f=0;f<solide[i].faces.size();f++){
+      for(int k=0;k<solide[i].faces[f].size();k++){
+	int num = solide[i].faces[f].vertex[k].num;
+	if(num >= (int)sommets.size()){
+	  sommets.resize(num+1);
 	}
-	Point_3 c1 = solide[i].mvt_t.transform(solide[i].faces[j].centre);
-	Point_3 c2 = solide[part].mvt_t.transform(solide[i].faces[j].centre);
-	Vector_3 Delta_u(c1,c2);
-	solide[i].epsilon += 1./2./(solide[i].V+N_dim*nu/(1.-2.*nu)*solide[i].Vl)*CGAL::to_double(Sn*Delta_u);
+	Position_sommet pos;
+	pos.particule = i;
+	pos.face = f;
+	pos.sommet = k;
+	sommets[num].push_back(pos);
+      }
+    }
+  }
+  particules_sommets.assign(sommets.size(),std::vector<int>());
+  coordonnees_sommets.assign(sommets.size(),Vecteur_3());
+  positions_sommets.assign(sommets.size(),std::vector<Vecteur_3>());
+  for(int num=0;num<sommets.size();num++){
+    for(int n=0;n<sommets[num].size();n++){
+      const Position_sommet& pos = sommets[num][n];
+      if(std::find(particules_sommets[num].begin(),particules_sommets[num].end(),pos.particule) == particules_sommets[num].end()){
+	particules_sommets[num].push_back(pos.particule);
       }
+      coordonnees_sommets[num] = Vecteur_3(Vector_3(Point_3(0.,0.,0.),solide[pos.particule].faces[pos.face].vertex[pos.sommet].pos));
+    }
+    positions_sommets[num].resize(particules_sommets[num].size());
+  }
+}
+
+/*!\brief Relative displacement of the two particles of a link at the center of their common face.
+ *\param L link
+ *\return Vecteur_3
+ */
+Vecteur_3 Solide::Deplacement_relatif(const Lien& L){
+  const Particule& Pi = solide[L.i];
+  const Particule& Pj = solide[L.j];
+  return L.X0iX0j + Pj.Dx - Pi.Dx + Pj.rotation(L.XCj) - Pi.rotation(L.XCi);
+}
+
+/*!\brief Computation of the volumetric deformation \a Particule.epsilon of each particle.
+ *\details The contributions of the links are computed in parallel, then gathered by each particle in the order of \a Solide.liens_particule. The free volumes \a Particule.Vl, computed on the lazy exact vertices of the faces, are updated first in a serial loop.
+ *\return void
+ */
+void Solide::Deformation_volumique(){
+  const int nb_liens = liens.size();
+  std::vector<double> dv_i(nb_liens,0.), dv_j(nb_liens,0.);
+#pragma omp parallel for schedule(static)
+  for(int l=0;l<nb_liens;l++){
+    const Lien& L = liens[l];
+    if(L.actif){
+      Vecteur_3 Delta_u = Deplacement_relatif(L);
+      dv_i[l] = L.Sni*Delta_u;
+      dv_j[l] = -(L.Snj*Delta_u);
     }
   }
-  //Computation of forces
   for(int i=0;i<size();i++){
-    for(int j=0;j<solide[i].faces.size();j++){
-      if(solide[i].faces[j].voisin>=0){
-	int part = solide[i].faces[j].voisin;
-	double S = solide[i].faces[j].S;
-	Vector_3 X1X2(solide[i].mvt_t.transform(solide[i].x0),solide[part].mvt_t.transform(solide[part].x0));
-	double DIJ = sqrt(CGAL::to_double(X1X2.squared_length()));
-	Vector_3 nIJ = X1X2/DIJ;
-	Point_3 c1 = solide[i].mvt_t.transform(solide[i].faces[j].centre);
-	Point_3 c2 = solide[part].mvt_t.transform(solide[i].faces[j].centre);
-	Vector_3 Delta_u(c1,c2);
-	Vector_3 XC1(solide[i].x0,solide[i].faces[j].centre);
-	Vector_3 XC2(solide[part].x0,solide[i].faces[j].centre);
-	double alpha = sqrt(CGAL::to_double(XC1.squared_length()))/(solide[i].faces[j].D0);
-	double epsilonIJ = alpha*solide[i].epsilon+(1.-alpha)*solide[part].epsilon;
-	//Elastic traction-compression force
-	solide[i].Fi = solide[i].Fi + S/solide[i].faces[j].D0*E/(1.+nu)*Delta_u;
-	//Elastic volumetric deformation force
-	solide[i].Fi = solide[i].Fi + S*E*nu/(1.+nu)/(1.-2.*nu)*epsilonIJ*(nIJ+Delta_u/DIJ-(Delta_u*nIJ)/DIJ*nIJ);
-	//Torque of the applied forces
-	solide[i].Mi = solide[i].Mi + cross_product(solide[i].mvt_t.transform(XC1),S/solide[i].faces[j].D0*E/(1.+nu)*Delta_u);
-	solide[i].Mi = solide[i].Mi + cross_product(solide[i].mvt_t.transform(XC1),S*E*nu/(1.+nu)/(1.-2.*nu)*epsilonIJ*(nIJ+Delta_u/DIJ-(Delta_u*nIJ)/DIJ*nIJ));
-	//Flexion/torsion torque
-	double kappa = 1.;
-	double alphan = (2.+2.*nu-kappa)*E/4./(1.+nu)/S*(solide[i].faces[j].Is+solide[i].faces[j].It);
-	double alphas = E/4./(1.+nu)/S*((2.+2.*nu+kappa)*solide[i].faces[j].Is-(2.+2.*nu-kappa)*solide[i].faces[j].It);
-	double alphat = E/4./(1.+nu)/S*((2.+2.*nu+kappa)*solide[i].faces[j].It-(2.+2.*nu-kappa)*solide[i].faces[j].Is);
-	solide[i].Mi = solide[i].Mi + S/solide[i].faces[j].D0*(alphan*cross_product(solide[i].mvt_t.transform(solide[i].faces[j].normale),solide[part].mvt_t.transform(solide[i].faces[j].normale))+alphas*cross_product(solide[i].mvt_t.transform(solide[i].faces[j].s),solide[part].mvt_t.transform(solide[i].faces[j].s))+alphat*cross_product(solide[i].mvt_t.transform(solide[i].faces[j].t),solide[part].mvt_t.transform(solide[i].faces[j].t)));
+    solide[i].Volume_libre();
+  }
+#pragma omp parallel for schedule(static)
+  for(int i=0;i<size();i++){
+    double dv = 0.;
+    for(int k=0;k<liens_particule[i].size();k++){
+      int l = liens_particule[i][k];
+      if(liens[l].actif){
+	dv += (liens[l].i == i) ? dv_i[l] : dv_j[l];
       }
     }
+    solide[i].epsilon = 1./2./(solide[i].V+N_dim*nu/(1.-2.*nu)*solide[i].Vl)*dv;
+  }
+}
+
+/*!\brief Computation of internal forces. 
+ *\details Each link is evaluated once, in parallel (OpenMP, compile with -fopenmp), and opposite forces and torques are applied to the two particles. Each particle then gathers the contributions of its links in the order of \a Solide.liens_particule, so that the result does not depend on the number of threads.
+ *\warning Both parallel loops only use double data (\a Particule.rotation, \a Solide.Deplacement_relatif): no lazy exact object may be used in them, CGAL not being compiled with thread support (CGAL_HAS_THREADS).
+ *\return void
+ */
+void Solide::Forces_internes(){
+  //Computation of the volumetric deformation epsilon of each particle
+  Deformation_volumique();
+  //Computation of the forces and torques of each link
+  const int nb_liens = liens.size();
+  std::vector<Vecteur_3> F_liens(nb_liens), Mi_liens(nb_liens), Mj_liens(nb_liens);
+#pragma omp parallel for schedule(static)
+  for(int l=0;l<nb_liens;l++){
+    const Lien& L = liens[l];
+    if(L.actif){
+      const Particule& Pi = solide[L.i];
+      const Particule& Pj = solide[L.j];
+      Vecteur_3 X1X2 = L.X0iX0j + Pj.Dx - Pi.Dx;
+      double DIJ = sqrt(X1X2.squared_length());
+      Vecteur_3 nIJ = X1X2/DIJ;
+      Vecteur_3 Delta_u = Deplacement_relatif(L);
+      double epsilonIJ = L.alpha*Pi.epsilon+(1.-L.alpha)*Pj.epsilon;
+      //Elastic traction-compression force and volumetric deformation force
+      Vecteur_3 F = L.S/L.D0*E/(1.+nu)*Delta_u;
+      F += L.S*E*nu/(1.+nu)/(1.-2.*nu)*epsilonIJ*(nIJ+Delta_u/DIJ-(Delta_u*nIJ)/DIJ*nIJ);
+      //Flexion/torsion torque
+      Vecteur_3 n1 = Pi.rotation(L.normale), n2 = Pj.rotation(L.normale);
+      Vecteur_3 s1 = Pi.rotation(L.s), s2 = Pj.rotation(L.s);
+      Vecteur_3 t1 = Pi.rotation(L.t), t2 = Pj.rotation(L.t);
+      Vecteur_3 M = L.S/L.D0*(L.alphan*cross_product(n1,n2)+L.alphas*cross_product(s1,s2)+L.alphat*cross_product(t1,t2));
+      //Torques applied on each particle (torque of the force + flexion/torsion)
+      F_liens[l] = F;
+      Mi_liens[l] = cross_product(Pi.rotation(L.XCi),F) + M;
+      Mj_liens[l] = -cross_product(Pj.rotation(L.XCj),F) - M;
+    }
+  }
+  //Gather the contributions on each particle
+#pragma omp parallel for schedule(static)
+  for(int i=0;i<size();i++){
+    Vecteur_3 Fi(0.,0.,0.), Mi(0.,0.,0.);
+    for(int k=0;k<liens_particule[i].size();k++){
+      int l = liens_particule[i][k];
+      if(liens[l].actif){
+	if(liens[l].i == i){
+	  Fi += F_liens[l];
+	  Mi += Mi_liens[l];
+	} else {
+	  Fi -= F_liens[l];
+	  Mi += Mj_liens[l];
+	}
+      }
+    }
+    solide[i].Fi = Fi;
+    solide[i].Mi = Mi;
   }
 }
 
@@ -2087,96 +2313,44 @@ double Solide::Energie(){
  *\return void
  */
 double Solide::Energie_cinetique(){
-  double E = 0.;
+  std::vector<double> Ec(size());
+#pragma omp parallel for schedule(static)
   for(int i=0;i<size();i++){
-    double u2 = CGAL::to_double(solide[i].u.squared_length());
-    E += 1./2.*solide[i].m*u2;
-    //Compute -1/2*tr(D j(Q^T omega)) = 1/2*(I1*Omega1^2+I2*Omega2^2+I3*Omega3^2)
-    double Q[3][3];
-    double rot[3][3];
-    double e0 = sqrt(1.-CGAL::to_double(solide[i].e.squared_length()));
-    //Recover the rotation matrix
-    rot[0][0] = 1.-2.*CGAL::to_double(solide[i].e.operator[](1)*solide[i].e.operator[](1)+solide[i].e.operator[](2)*solide[i].e.operator[](2));
-    rot[0][1] = 2.*CGAL::to_double(-e0*solide[i].e.operator[](2)+solide[i].e.operator[](0)*solide[i].e.operator[](1));
-    rot[0][2] = 2.*CGAL::to_double(e0*solide[i].e.operator[](1)+solide[i].e.operator[](0)*solide[i].e.operator[](2));
-    rot[1][0] = 2.*CGAL::to_double(e0*solide[i].e.operator[](2)+solide[i].e.operator[](1)*solide[i].e.operator[](0));
-    rot[1][1] = 1.-2.*CGAL::to_double(solide[i].e.operator[](0)*solide[i].e.operator[](0)+solide[i].e.operator[](2)*solide[i].e.operator[](2));
-    rot[1][2] = 2.*CGAL::to_double(-e0*solide[i].e.operator[](0)+solide[i].e.operator[](1)*solide[i].e.operator[](2));
-    rot[2][0] = 2.*CGAL::to_double(-e0*solide[i].e.operator[](1)+solide[i].e.operator[](2)*solide[i].e.operator[](0));
-    rot[2][1] = 2.*CGAL::to_double(e0*solide[i].e.operator[](0)+solide[i].e.operator[](2)*solide[i].e.operator[](1));
-    rot[2][2] = 1.-2.*CGAL::to_double(solide[i].e.operator[](0)*solide[i].e.operator[](0)+solide[i].e.operator[](1)*solide[i].e.operator[](1));
-    for(int j=0;j<3;j++){
-      for(int k=0;k<3;k++){
-	Q[j][k] = rot[j][0]*solide[i].rotref[0][k];
-	Q[j][k] += rot[j][1]*solide[i].rotref[1][k];
-	Q[j][k] += rot[j][2]*solide[i].rotref[2][k];
-      }
-    }  
-    double Omega[3];
-    Omega[0] = Omega[1] = Omega[2] = 0.;
-    for(int j=0;j<3;j++){
-      for(int k=0;k<3;k++){
-	Omega[j] += CGAL::to_double(solide[i].omega.operator[](k)*Q[k][j]);
-      }
-    }
-    E += 1./2.*(solide[i].I[0]*Omega[0]*Omega[0]+solide[i].I[1]*Omega[1]*Omega[1]+solide[i].I[2]*Omega[2]*Omega[2]);
+    Ec[i] = solide[i].Energie_cinetique();
   }
-  return E;
+  return Somme(Ec);
 }
 
 /*! \brief Compute the potential energy of the solid. 
  * \return void
  */
 double Solide::Energie_potentielle(){
-  double Ep = 0.;
   //Compute the volumetric deformation epsilon of each particle
+  Deformation_volumique();
+  std::vector<double> Ep_particules(size()), Ep_liens(liens.size(),0.);
+#pragma omp parallel for schedule(static)
   for(int i=0;i<size();i++){
-    solide[i].Volume_libre();
-    solide[i].epsilon = 0.;
-    for(int j=0;j<solide[i].faces.size();j++){
-      if(solide[i].faces[j].voisin>=0){
-	int part = solide[i].faces[j].voisin;
-	Vector_3 Sn = Vector_3(0.,0.,0.);
-	for(int k=1;k<solide[i].faces[j].size()-1;k++){
-	  Sn = Sn + 1./2.*cross_product(Vector_3(solide[i].faces[j].vertex[0].pos,solide[i].faces[j].vertex[k].pos),Vector_3(solide[i].faces[j].vertex[0].pos,solide[i].faces[j].vertex[k+1].pos));
-	}
-	Point_3 c1 = solide[i].mvt_t.transform(solide[i].faces[j].centre);
-	Point_3 c2 = solide[part].mvt_t.transform(solide[i].faces[j].centre);
-	Vector_3 Delta_u(c1,c2);
-	solide[i].epsilon += 1./2./(solide[i].V+N_dim*nu/(1.-2.*nu)*solide[i].Vl)*CGAL::to_double(Sn*Delta_u);
-      }
-    }
     //Volumetric deformation energy
-    Ep += E*nu/2./(1.+nu)/(1.-2.*nu)*(solide[i].V+N_dim*nu/(1.-2.*nu)*solide[i].Vl)*pow(solide[i].epsilon,2);
+    Ep_particules[i] = E*nu/2./(1.+nu)/(1.-2.*nu)*(solide[i].V+N_dim*nu/(1.-2.*nu)*solide[i].Vl)*pow(solide[i].epsilon,2);
   }
   //Compute the energy associated with each particle link
-  for(int i=0;i<size();i++){
-    for(int j=0;j<solide[i].faces.size();j++){
-      if(solide[i].faces[j].voisin>=0){
-	int part = solide[i].faces[j].voisin;
-	double S = solide[i].faces[j].S;
-	Vector_3 X1X2(solide[i].mvt_t.transform(solide[i].x0),solide[part].mvt_t.transform(solide[part].x0));
-	double DIJ = sqrt(CGAL::to_double(X1X2.squared_length()));
-	Vector_3 nIJ = X1X2/DIJ;
-	Point_3 c1 = solide[i].mvt_t.transform(solide[i].faces[j].centre);
-	Point_3 c2 = solide[part].mvt_t.transform(solide[i].faces[j].centre);
-	Vector_3 Delta_u(c1,c2);
-	Vector_3 XC1(solide[i].x0,solide[i].faces[j].centre);
-	Vector_3 XC2(solide[part].x0,solide[i].faces[j].centre);
-	double alpha = sqrt(CGAL::to_double(XC1.squared_length()))/(solide[i].faces[j].D0);
-	double epsilonIJ = alpha*solide[i].epsilon+(1.-alpha)*solide[part].epsilon;
-	//Elastic traction/compression energy
-	Ep += 1./4.*S/solide[i].faces[j].D0*E/(1.+nu)*CGAL::to_double(Delta_u*Delta_u);
-	//Flexion/torsion torques
-	double kappa = 1.;
-	double alphan = (2.+2.*nu-kappa)*E/4./(1.+nu)/S*(solide[i].faces[j].Is+solide[i].faces[j].It);
-	double alphas = E/4./(1.+nu)/S*((2.+2.*nu+kappa)*solide[i].faces[j].Is-(2.+2.*nu-kappa)*solide[i].faces[j].It);
-	double alphat = E/4./(1.+nu)/S*((2.+2.*nu+kappa)*solide[i].faces[j].It-(2.+2.*nu-kappa)*solide[i].faces[j].Is);
-	Ep += S/2./solide[i].faces[j].D0*(alphan*(1.-CGAL::to_double(solide[i].mvt_t.transform(solide[i].faces[j].normale)*solide[part].mvt_t.transform(solide[i].faces[j].normale)))+alphas*(1.-CGAL::to_double(solide[i].mvt_t.transform(solide[i].faces[j].s)*solide[part].mvt_t.transform(solide[i].faces[j].s)))+alphat*(1.-CGAL::to_double(solide[i].mvt_t.transform(solide[i].faces[j].t)*solide[part].mvt_t.transform(solide[i].faces[j].t))));
-      }
-    }
-  }
-  return Ep;
+#pragma omp parallel for schedule(static)
+  for(int l=0;l<liens.size();l++){
+    const Lien& L = liens[l];
+    if(L.actif){
+      const Particule& Pi = solide[L.i];
+      const Particule& Pj = solide[L.j];
+      Vecteur_3 Delta_u = Deplacement_relatif(L);
+      //Elastic traction/compression energy
+      Ep_liens[l] = 1./2.*L.S/L.D0*E/(1.+nu)*(Delta_u*Delta_u);
+      //Flexion/torsion torques
+      Vecteur_3 n1 = Pi.rotation(L.normale), n2 = Pj.rotation(L.normale);
+      Vecteur_3 s1 = Pi.rotation(L.s), s2 = Pj.rotation(L.s);
+      Vecteur_3 t1 = Pi.rotation(L.t), t2 = Pj.rotation(L.t);
+      Ep_liens[l] += L.S/L.D0*(L.alphan*(1.-n1*n2)+L.alphas*(1.-s1*s2)+L.alphat*(1.-t1*t2));
+    }
+  }
+  return Somme(Ep_particules)+Somme(Ep_liens);
 }
 
 double Solide::pas_temps(double t, double T){
@@ -2206,19 +2380,66 @@ double Solide::pas_temps(double t, double T){
   return dt;
 }
 
+//! Image of X by the affine transformation M (3x4 matrix stored by rows)
+static inline Vecteur_3 transforme(const double* M, const Vecteur_3& X){
+  return Vecteur_3(M[0]*X[0]+M[1]*X[1]+M[2]*X[2]+M[3],
+		   M[4]*X[0]+M[5]*X[1]+M[6]*X[2]+M[7],
+		   M[8]*X[0]+M[9]*X[1]+M[10]*X[2]+M[11]);
+}
+
+/*!\brief Position of a face vertex at time t.
+ *\details Average of the positions of the vertex moved by the particles of \a Vertex.particules, read in \a Solide.positions_sommets. The positions are added in the order of \a Solide.particules_sommets, whatever the order of \a Vertex.particules in the face: all the copies of a vertex with the same particles get bitwise identical coordinates, and the surface stays watertight.
+ *\param V vertex
+ *\return Vecteur_3
+ */
+Vecteur_3 Solide::Position_vertex(const Vertex& V){
+  const std::vector<int>& parts = particules_sommets[V.num];
+  Vecteur_3 X(0.,0.,0.);
+  for(int n=0;n<parts.size();n++){
+    if(std::find(V.particules.begin(),V.particules.end(),parts[n]) != V.particules.end()){
+      X += positions_sommets[V.num][n];
+    }
+  }
+  return X/V.particules.size();
+}
+
 /*!\brief Update the fluid/solid interface.
- *\details Update \a Particule.triangles_prev, \a Particule.triangles, \a Particule.normales_prev, \a Particule.normales, \a Particule.fluide_prev, \a Particule.fluide, \a Particule.Points_interface_prev, \a Particule.Points_interface, \a Particule.Triangles_interface_prev, \a Particule.Triangles_interface, \a Particule.Position_Triangles_interface_prev and \a Particule.Position_Triangles_interface.
+ *\details Update \a Particule.triangles_prev, \a Particule.triangles, \a Particule.normales_prev, \a Particule.normales, \a Particule.fluide_prev, \a Particule.fluide, \a Particule.Points_interface_prev, \a Particule.Points_interface, \a Particule.Triangles_interface_prev, \a Particule.Triangles_interface, \a Particule.Position_Triangles_interface_prev and \a Particule.Position_Triangles_interface. \n
+ Each vertex of the mesh is first moved once by each particle containing it (\a Solide.positions_sommets), in parallel and in double precision, then the triangles of the faces are assembled from these positions (see \a Solide.Position_vertex).
+ *\warning The assembly builds lazy exact points and triangles, whose representations are shared between particles: it runs in parallel only with -DCELIA3D_SWAP_PARALLELE (see \a Grille.Swap_2d).
  *\return void
  */
 void Solide::update_triangles(){
+  //Rigid body movements of the particles
+  std::vector<double> mvt(12*size());
+  for(int i=0;i<size();i++){
+    Vecteur_3 X0(Vector_3(Point_3(0.,0.,0.),solide[i].x0));
+    Vecteur_3 T = X0 + solide[i].Dx - solide[i].rotation(X0);
+    for(int a=0;a<3;a++){
+      for(int b=0;b<3;b++){
+	mvt[12*i+4*a+b] = solide[i].rot_t[a][b];
+      }
+      mvt[12*i+4*a+3] = T[a];
+    }
+  }
+  //Positions of the vertices moved by each particle
+#pragma omp parallel for schedule(static)
+  for(int num=0;num<particules_sommets.size();num++){
+    for(int n=0;n<particules_sommets[num].size();n++){
+      positions_sommets[num][n] = transforme(&mvt[12*particules_sommets[num][n]],coordonnees_sommets[num]);
+    }
+  }
+#ifdef CELIA3D_SWAP_PARALLELE
+#pragma omp parallel for schedule(dynamic)
+#endif
   for(int i=0;i<solide.size();i++){
-    solide[i].triangles_prev = solide[i].triangles;
-    solide[i].normales_prev = solide[i].normales;
-    solide[i].fluide_prev = solide[i].fluide;
-    for(int it=0;it<solide[i].triangles.size();it++){
-      solide[i].Points_interface_prev[it] = solide[i].Points_interface[it];
-      solide[i].Triangles_interface_prev[it] = solide[i].Triangles_interface[it];
-      solide[i].Position_Triangles_interface_prev[it] = solide[i].Position_Triangles_interface[it];
+    solide[i].triangles_prev.swap(solide[i].triangles);
+    solide[i].normales_prev.swap(solide[i].normales);
+    solide[i].fluide_prev.swap(solide[i].fluide);
+    for(int it=0;it<solide[i].triangles_prev.size();it++){
+      solide[i].Points_interface_prev[it].swap(solide[i].Points_interface[it]);
+      solide[i].Triangles_interface_prev[it].swap(solide[i].Triangles_interface[it]);
+      solide[i].Position_Triangles_interface_prev[it].swap(solide[i].Position_Triangles_interface[it]);
       solide[i].Points_interface[it].erase(solide[i].Points_interface[it].begin(),solide[i].Points_interface[it].end());
       solide[i].Triangles_interface[it].erase(solide[i].Triangles_interface[it].begin(),solide[i].Triangles_interface[it].end());	solide[i].Position_Triangles_interface[it].erase(solide[i].Position_Triangles_interface[it].begin(),
 																							 solide[i].Position_Triangles_interface[it].end());
@@ -2230,97 +2451,68 @@ void Solide::update_triangles(){
 		
     //Compute the new position of triangles
     for(int f=0;f<solide[i].faces.size();f++){
-      Point_3 s,r,v,t;
-			
+      const Face& F = solide[i].faces[f];
+      const bool fluide = (F.voisin < 0);
+      const bool vide = (F.voisin == -2);
       if(solide[i].faces[f].size() == 3){
-	vector<Point_3> ri,vi,si ;
-	for(int part=0; part<solide[i].faces[f].vertex[0].size();part++){
-	  int p = solide[i].faces[f].vertex[0].particules[part];
-	  ri.push_back(solide[p].mvt_t.transform(solide[i].faces[f].vertex[0].pos));
-	}
-	r = centroid(ri.begin(),ri.end());
-				
-				
-	for(int part=0;part<solide[i].faces[f].vertex[1].size();part++){
-	  int p = solide[i].faces[f].vertex[1].particules[part];
-	  vi.push_back(solide[p].mvt_t.transform(solide[i].faces[f].vertex[1].pos));
-	}
-	v = centroid(vi.begin(),vi.end());
-
-	for(int part=0;part<solide[i].faces[f].vertex[2].size();part++){
-	  int p = solide[i].faces[f].vertex[2].particules[part];
-	  si.push_back(solide[p].mvt_t.transform(solide[i].faces[f].vertex[2].pos));
-	}
-	s = centroid(si.begin(),si.end());
-				
-	Vector_3 vect0(r,v);
-	Vector_3 vect1(r,s);
-	Triangle_3 Tri(r,v,s);
-	solide[i].triangles.push_back(Tri);
-	Vector_3 normale = CGAL::cross_product(vect0,vect1);
-	normale = normale*(1./sqrt(CGAL::to_double(normale.squared_length())));
-	solide[i].normales.push_back(normale);
-	if(solide[i].faces[f].voisin < 0){
-	  solide[i].fluide.push_back(true);
-	} else {
-	  solide[i].fluide.push_back(false);
-	}
-	if( solide[i].faces[f].voisin == -2){
-	  solide[i].vide.push_back(true);
-	} else {
-	  solide[i].vide.push_back(false);
-	}
+	Vecteur_3 r = Position_vertex(F.vertex[0]);
+	Vecteur_3 v = Position_vertex(F.vertex[1]);
+	Vecteur_3 s = Position_vertex(F.vertex[2]);
+	solide[i].triangles.push_back(Triangle_3(Point_3(r[0],r[1],r[2]),Point_3(v[0],v[1],v[2]),Point_3(s[0],s[1],s[2])));
+	Vecteur_3 normale = cross_product(v-r,s-r);
+	normale = normale/sqrt(normale.squared_length());
+	solide[i].normales.push_back(normale.vector_3());
+	solide[i].fluide.push_back(fluide);
+	solide[i].vide.push_back(vide);
       }
       else{
-			
-	vector<Point_3> si;
-	si.push_back(solide[i].mvt_t.transform(solide[i].faces[f].centre));
-	int j = solide[i].faces[f].voisin;
+	Vecteur_3 C(Vector_3(Point_3(0.,0.,0.),F.centre));
+	Vecteur_3 s = transforme(&mvt[12*i],C);
+	int j = F.voisin;
 	if(j>=0){
-	  si.push_back(solide[j].mvt_t.transform(solide[i].faces[f].centre));
+	  s = (s + transforme(&mvt[12*j],C))/2.;
 	}
-	s = centroid(si.begin(),si.end());
-			
-	for(int k=0;k<solide[i].faces[f].size();k++){
-	  int kp = (k+1)%(solide[i].faces[f].size());
-	  vector<Point_3> ri,vi;
-	  for(int part=0;part<solide[i].faces[f].vertex[k].size();part++){
-	    int p = solide[i].faces[f].vertex[k].particules[part];
-	    ri.push_back(solide[p].mvt_t.transform(solide[i].faces[f].vertex[k].pos));
-	  }
-	  r = centroid(ri.begin(),ri.end());
-	  for(int part=0;part<solide[i].faces[f].vertex[kp].size();part++){
-	    int p = solide[i].faces[f].vertex[kp].particules[part];
-	    vi.push_back(solide[p].mvt_t.transform(solide[i].faces[f].vertex[kp].pos));
-	  }
-	  v = centroid(vi.begin(),vi.end());
-	  Vector_3 vect0(s,r);
-	  Vector_3 vect1(s,v);
-	  Triangle_3 Tri(s,r,v);
-	  solide[i].triangles.push_back(Tri);
-	  Vector_3 normale = CGAL::cross_product(vect0,vect1);
-	  normale = normale*(1./sqrt(CGAL::to_double(normale.squared_length())));			  
-	  solide[i].normales.push_back(normale);
-	  if(solide[i].faces[f].voisin < 0){
-	    solide[i].fluide.push_back(true);
-	  } 
-	  else {
-	    solide[i].fluide.push_back(false);
-	  }
-	  if( solide[i].faces[f].voisin == -2){
-	    solide[i].vide.push_back(true);
-	  } else {
-	    solide[i].vide.push_back(false);
-	  }
+	Point_3 S(s[0],s[1],s[2]);
+	Vecteur_3 v = Position_vertex(F.vertex[0]);
+	for(int k=0;k<F.vertex.size();k++){
+	  int kp = (k+1)%(F.vertex.size());
+	  Vecteur_3 r = v;
+	  v = Position_vertex(F.vertex[kp]);
+	  solide[i].triangles.push_back(Triangle_3(S,Point_3(r[0],r[1],r[2]),Point_3(v[0],v[1],v[2])));
+	  Vecteur_3 normale = cross_product(r-s,v-s);
+	  normale = normale/sqrt(normale.squared_length());
+	  solide[i].normales.push_back(normale.vector_3());
+	  solide[i].fluide.push_back(fluide);
+	  solide[i].vide.push_back(vide);
 	}
       }
-			
     }
-		
   }
 }
 
 
+/*!\brief Sum of the elements of a vector.
+ *\details The sum is computed in parallel unless \a solide_reproductible is true, in which case the elements are added in their order with a compensated summation (\a Somme_compensee).
+ *\param v vector
+ *\return double
+ */
+double Somme(const std::vector<double>& v){
+  const int n = v.size();
+  if(solide_reproductible){
+    Somme_compensee somme;
+    for(int i=0;i<n;i++){
+      somme.ajoute(v[i]);
+    }
+    return somme.valeur();
+  }
+  double somme = 0.;
+#pragma omp parallel for reduction(+:somme)
+  for(int i=0;i<n;i++){
+    somme += v[i];
+  }
+  return somme;
+}
+
 /*!\brief Compute the error for the semi-implicit scheme.
  *\details The function is used as a stopping criterion in the semi-implicit scheme:  \n
  \f{eqnarray*}{ error = max( \, \Vert S1.solide[i].Dx -  S2.solide[i].Dx \, \Vert_{\infty} + h_{max} \Vert \, S1.solide[i].e -  S2.solide[i].e \, \Vert_{\infty})_i  \f}\n
@@ -2354,6 +2546,106 @@ double Error(Solide& S1, Solide& S2){
   return erreur;
 }	
 
+/*!\brief Compute the error for the semi-implicit scheme with regards to a kinematic snapshot.
+ *\details Same as \a Error(Solide&, Solide&), with the solid at iteration k-1 given by its kinematic state.
+ *\param S1 \a Solide at iteration k of the fixed-point procedure
+ *\param S2 kinematic state of the \a Solide at iteration k-1 of the fixed-point procedure
+ *\warning <b> Specific coupling procedure ! </b>
+ *\return double
+ */
+double Error(Solide& S1, const Etat_solide& S2){
+	
+  double erreur = -1.;
+	
+  for(int it=0; it<S1.size(); it++){
+    const Etat_cinematique& P2 = S2.solide[it];
+    double h_max1 = std::max(std::max((S1.solide[it].bbox.xmax() - S1.solide[it].bbox.xmin()),(S1.solide[it].bbox.ymax() - S1.solide[it].bbox.ymin())),              (S1.solide[it].bbox.zmax() - S1.solide[it].bbox.zmin())); 
+    double h_max2 = std::max(std::max((P2.bbox.xmax() - P2.bbox.xmin()),(P2.bbox.ymax() - P2.bbox.ymin())),              (P2.bbox.zmax() - P2.bbox.zmin())); 
+    double h_max = max(h_max1, h_max2);
+    double err1 = std::max(std::max(std::abs(CGAL::to_double(S1.solide[it].Dx.operator[](0) - P2.Dx.operator[](0))), std::abs(CGAL::to_double(S1.solide[it].Dx.operator[](1) - P2.Dx.operator[](1)) )), std::abs(CGAL::to_double(S1.solide[it].Dx.operator[](2) - P2.Dx.operator[](2)))); 
+    double err2 = std::max(std::max(std::abs(CGAL::to_double(S1.solide[it].e.operator[](0) - P2.e.operator[](0))), std::abs(CGAL::to_double(S1.solide[it].e.operator[](1) - P2.e.operator[](1)))), std::abs(CGAL::to_double(S1.solide[it].e.operator[](2) - P2.e.operator[](2))));
+    double erreur_temp = err1 + h_max * err2;
+    erreur = std::max(erreur_temp, erreur);
+  }
+	
+  return erreur;
+}	
+
+/*!\brief Snapshot of the kinematic state of the solid.
+ *\details Only the members modified by \a Solide.Solve_position are stored (a few hundred bytes per particle), the geometry of the particles is not copied.
+ *\param etat kinematic state
+ *\warning <b> Specific coupling procedure ! </b>
+ *\return void
+ */
+void Solide::Sauvegarde(Etat_solide& etat){
+  etat.solide.resize(size());
+  for(int i=0; i<size(); i++){
+    const Particule& P = solide[i];
+    Etat_cinematique& Ei = etat.solide[i];
+    Ei.Dx = P.Dx; Ei.Dxprev = P.Dxprev;
+    Ei.u = P.u; Ei.u_half = P.u_half;
+    Ei.omega = P.omega; Ei.omega_half = P.omega_half;
+    Ei.e = P.e; Ei.eprev = P.eprev;
+    Ei.Ff = P.Ff; Ei.Ffprev = P.Ffprev;
+    Ei.Mf = P.Mf; Ei.Mfprev = P.Mfprev;
+    Ei.Fi = P.Fi; Ei.Mi = P.Mi;
+    Ei.epsilon = P.epsilon;
+    Ei.mvt_t = P.mvt_t; Ei.mvt_tprev = P.mvt_tprev;
+    memcpy(Ei.rot_t,P.rot_t,sizeof(P.rot_t)); memcpy(Ei.Q_t,P.Q_t,sizeof(P.Q_t)); memcpy(Ei.quaternion,P.quaternion,sizeof(P.quaternion));
+    Ei.bbox = P.bbox;
+    Ei.voisin.resize(P.faces.size());
+    for(int f=0; f<P.faces.size(); f++){
+      Ei.voisin[f] = P.faces[f].voisin;
+    }
+  }
+  etat.nb_positions = nb_positions;
+  etat.nb_ruptures = nb_ruptures;
+}
+
+/*!\brief Restoration of the solid from a kinematic snapshot taken with \a Solide.Sauvegarde.
+ *\details The kinematic state is restored. If \a Solide.Solve_position has been called once since the snapshot, the interface geometry at time t (\a Particule.triangles, \a Particule.Triangles_interface, ...) is recovered from the one at time t-dt (swap of the vectors), so that a new call to \a Solide.Solve_position gives the same result as on the original solid. \n
+ The restoration fails if links were broken or if the position was updated more than once since the snapshot: the solid must then be copied entirely.
+ *\param etat kinematic state
+ *\warning <b> Specific coupling procedure ! </b>
+ *\return bool: true if the solid was restored
+ */
+bool Solide::Restauration(const Etat_solide& etat){
+  if(etat.solide.size()!=size() || etat.nb_ruptures!=nb_ruptures || nb_positions<etat.nb_positions || nb_positions>etat.nb_positions+1){
+    return false;
+  }
+  const bool geometrie = (nb_positions==etat.nb_positions+1);
+  for(int i=0; i<size(); i++){
+    Particule& P = solide[i];
+    const Etat_cinematique& Ei = etat.solide[i];
+    P.Dx = Ei.Dx; P.Dxprev = Ei.Dxprev;
+    P.u = Ei.u; P.u_half = Ei.u_half;
+    P.omega = Ei.omega; P.omega_half = Ei.omega_half;
+    P.e = Ei.e; P.eprev = Ei.eprev;
+    P.Ff = Ei.Ff; P.Ffprev = Ei.Ffprev;
+    P.Mf = Ei.Mf; P.Mfprev = Ei.Mfprev;
+    P.Fi = Ei.Fi; P.Mi = Ei.Mi;
+    P.epsilon = Ei.epsilon;
+    P.mvt_t = Ei.mvt_t; P.mvt_tprev = Ei.mvt_tprev;
+    memcpy(P.rot_t,Ei.rot_t,sizeof(P.rot_t)); memcpy(P.Q_t,Ei.Q_t,sizeof(P.Q_t)); memcpy(P.quaternion,Ei.quaternion,sizeof(P.quaternion));
+    P.bbox = Ei.bbox;
+    for(int f=0; f<P.faces.size(); f++){
+      P.faces[f].voisin = Ei.voisin[f];
+    }
+    if(geometrie){
+      P.triangles.swap(P.triangles_prev);
+      P.normales.swap(P.normales_prev);
+      P.fluide.swap(P.fluide_prev);
+      for(int it=0; it<P.triangles.size(); it++){
+	P.Points_interface[it].swap(P.Points_interface_prev[it]);
+	P.Triangles_interface[it].swap(P.Triangles_interface_prev[it]);
+	P.Position_Triangles_interface[it].swap(P.Position_Triangles_interface_prev[it]);
+      }
+    }
+  }
+  nb_positions = etat.nb_positions;
+  return true;
+}
+
 /*! \brief Copy values of fluid forces \a Ff and torques \a Mf from S2 to S1.
  *  \details Function used in the semi-implicit scheme fixed-point procedure. 
  *	\param S1 \a Solide at time t
@@ -2369,6 +2661,107 @@ void Copy_f_m(Solide& S1, Solide& S2){
   }
 	
 }	
+/*!\brief Default constructor.
+ */
+Relaxation_Aitken::Relaxation_Aitken(){
+  omega = omega_max;
+  omega_prev = omega_max;
+  histogramme.resize(kmax_semi_implicite+1, 0);
+}
+
+/*!\brief Relaxation of the fluid forces and torques in the semi-implicit fixed-point procedure. Replaces \a Copy_f_m(Solide&, Solide&).
+ *  \details Let \f$ F_k \f$ the forces used at iteration k and \f$ \tilde{F}_{k+1} \f$ the forces computed on the resulting position of the solid. The residual is \f$ r_{k+1} = \tilde{F}_{k+1} - F_k \f$ and the new forces are
+ \f{eqnarray*}{
+ F_{k+1} = F_k + \omega_{k+1} r_{k+1}, \qquad \omega_{k+1} = -\omega_k \frac{r_k \cdot (r_{k+1}-r_k)}{|r_{k+1}-r_k|^2}.
+ \f}
+ At the first iteration, the forces are evaluated on the solid at time t: if \a extrapolation_forces is set, the difference between the converged and first evaluated forces of the previous time-step is added to them. At the first relaxed iteration, \f$ \omega = \min(\omega_{prev}, \omega_{max}) \f$, where \f$ \omega_{prev} \f$ is the last factor of the previous time-step. The factor is always kept in \f$ [\omega_{min}, \omega_{max}] \f$ (\a omega_min, \a omega_max), so that a nearly collinear pair of residuals cannot make the fixed point diverge.
+ *	\param S1 \a Solide at time t (receives the relaxed forces)
+ *	\param S2 \a Solide at iteration k of the fixed-point procedure (forces computed by \a Grille.Forces_fluide)
+ *	\param k index of the fixed-point iteration
+ *	\warning <b> Specific coupling procedure ! </b>
+ *	\return void
+ */
+void Relaxation_Aitken::Relaxation(Solide& S1, Solide& S2, const int k){
+  
+  const int n = 6*S2.size();
+  std::vector<double> Ft(n);
+  for(int it=0; it<S2.size(); it++){
+    for(int l=0; l<3; l++){
+      Ft[6*it+l] = S2.solide[it].Ff[l];
+      Ft[6*it+3+l] = S2.solide[it].Mf[l];
+    }
+  }
+  
+  if(k==0 || F.size()!=n){
+    F0 = Ft;
+    F = Ft;
+    if(extrapolation_forces && correction.size()==n){
+      for(int l=0; l<n; l++){
+	F[l] += correction[l];
+      }
+    }
+    r_prev.clear();
+    omega = std::min(omega_prev, omega_max);
+  }
+  else if(!relaxation_aitken){
+    F = Ft;
+  }
+  else {
+    std::vector<double> r(n);
+    for(int l=0; l<n; l++){
+      r[l] = Ft[l] - F[l];
+    }
+    if(r_prev.size()==n){
+      double num = 0., den = 0.;
+      for(int l=0; l<n; l++){
+	num += r_prev[l]*(r[l]-r_prev[l]);
+	den += (r[l]-r_prev[l])*(r[l]-r_prev[l]);
+      }
+      if(den>eps){
+	omega = std::max(omega_min, std::min(omega_max, -omega*num/den));
+      }
+    }
+    for(int l=0; l<n; l++){
+      F[l] += omega*r[l];
+    }
+    r_prev = r;
+  }
+  
+  for(int it=0; it<S1.size(); it++){
+    S1.solide[it].Ff = Vecteur_3(F[6*it],F[6*it+1],F[6*it+2]);
+    S1.solide[it].Mf = Vecteur_3(F[6*it+3],F[6*it+4],F[6*it+5]);
+  }
+}
+
+/*!\brief End of the semi-implicit fixed-point procedure for the time-step.
+ *  \details Stores the correction of the forces used for the extrapolation at the next time-step and updates the histogram of the number of iterations.
+ *	\param k number of fixed-point iterations
+ *	\warning <b> Specific coupling procedure ! </b>
+ *	\return void
+ */
+void Relaxation_Aitken::Fin(const int k){
+  correction.resize(F.size());
+  for(int l=0; l<F.size(); l++){
+    correction[l] = F[l] - F0[l];
+  }
+  omega_prev = omega;
+  histogramme[std::min(k, kmax_semi_implicite)]++;
+}
+
+/*!\brief Output of the histogram of the number of fixed-point iterations per time-step.
+ *	\param out output stream
+ *	\return void
+ */
+void Relaxation_Aitken::Affiche_histogramme(std::ostream& out){
+  out << "Semi-implicit iterations histogram (iterations:time-steps)";
+  for(int k=0; k<histogramme.size(); k++){
+    if(histogramme[k]>0){
+      out << " " << k << ":" << histogramme[k];
+    }
+  }
+  out << endl;
+}
+
 /*!\brief Check whether point P is in the Bbox cell
   \details Returns true if P is inside cell and false otherwise.
   *\param cell Bbox 
@@ -2526,15 +2919,241 @@ bool box_inside_tetra(const Tetrahedron &tetra, const Bbox& cell){
  *\return void
  */
 void Solide::Impression(int n){ 
-  int nb_part = solide.size();
+  Instantane_solide I;
+  Instantane(I,n);
+  Ecrit_instantane(I);
+}
+
+//! Key of a face vertex in \a Solide.Instantane: index of the mesh vertex (\a Vertex.num), then the sorted particles sharing it (\a Vertex.particules)
+static std::vector<int> Cle_sommet(const Vertex& V){
+  std::vector<int> cle(V.particules);
+  std::sort(cle.begin(),cle.end());
+  cle.insert(cle.begin(),V.num);
+  return cle;
+}
+
+//! Key of the center of the face \a f of the particle \a i of neighbour \a voisin in \a Solide.Instantane: shared by the two particles of a link, proper to the face otherwise
+static std::vector<int> Cle_centre(const int i, const int f, const int voisin){
+  std::vector<int> cle(3);
+  if(voisin>=0){
+    cle[0] = -1; cle[1] = std::min(i,voisin); cle[2] = std::max(i,voisin);
+  } else {
+    cle[0] = -2; cle[1] = i; cle[2] = f;
+  }
+  return cle;
+}
+
+//! Index of the vertex of key \a cle in \a numeros, added with the next index if it is new
+static int Numero_sommet(const std::vector<int>& cle, std::map<std::vector<int>,int>& numeros){
+  return numeros.insert(std::make_pair(cle,int(numeros.size()))).first->second;
+}
+
+/*!\brief Copy of the solid data written in the output files (see \a Ecrit_instantane(const Instantane_solide&)).
+ *\param I copy of the solid data
+ *\param n index of the output iteration
+ *\return void
+ */
+void Solide::Instantane(Instantane_solide& I, const int n){
+  const int nb_part = solide.size();
+  I.n = n;
+  I.nb_triangles.resize(nb_part);
+  I.Dx.resize(nb_part);
+  I.u.resize(nb_part);
+  I.e.resize(nb_part);
+  I.omega.resize(nb_part);
+  I.centres.resize(nb_part);
+  I.sommets.clear();
+  I.indices.clear();
+  std::map<std::vector<int>,int> numeros; //Distinct vertices of the triangles, numbered in the order of their first appearance
+  for(int it=0; it<nb_part; it++){
+    const Particule& P = solide[it];
+    I.nb_triangles[it] = P.triangles.size();
+    I.Dx[it] = P.Dx;
+    I.u[it] = P.u;
+    I.e[it] = P.e;
+    I.omega[it] = P.omega;
+    I.centres[it] = Vecteur_3(Vector_3(Point_3(0.,0.,0.),P.x0)) + P.Dx;
+    for(int l= 0; l<P.triangles.size(); l++){
+      for(int v=0; v<3; v++){
+	for(int m=0; m<3; m++){
+	  I.sommets.push_back(CGAL::to_double(P.triangles[l].operator[](v).operator[](m)));
+	}
+      }
+    }
+    //Vertices of the triangles, in the order of their construction (Particule constructor, then Solide::update_triangles)
+    for(int f=0, l=0; f<P.faces.size(); f++){
+      const Face& F = P.faces[f];
+      if(F.vertex.size()==3){
+	//The initial triangle is oriented along the face normal: its last two vertices may be exchanged
+	const bool inverse = (l<P.triangles.size() && P.triangles[l][1]==F.vertex[2].pos && P.triangles[l][2]==F.vertex[1].pos);
+	const int ordre[3] = {0, inverse ? 2 : 1, inverse ? 1 : 2};
+	for(int v=0; v<3; v++){
+	  I.indices.push_back(Numero_sommet(Cle_sommet(F.vertex[ordre[v]]),numeros));
+	}
+	l++;
+      }
+      else{
+	const int c = Numero_sommet(Cle_centre(it,f,F.voisin),numeros);
+	for(int k=0; k<F.vertex.size(); k++){
+	  const int kp = (k+1)%(F.vertex.size());
+	  I.indices.push_back(c);
+	  I.indices.push_back(Numero_sommet(Cle_sommet(F.vertex[k]),numeros));
+	  I.indices.push_back(Numero_sommet(Cle_sommet(F.vertex[kp]),numeros));
+	}
+	l += F.vertex.size();
+      }
+    }
+  }
+}
 
-  int nb_triangles = 0.;
+/*!\brief Table of the distinct vertices of the triangles of \a I.
+ *\details The vertices are identified by \a Instantane_solide.indices (mesh vertex and particles sharing it, see \a Solide.Instantane), so that the copies of a vertex separated by a broken link stay distinct even at the same position. They are written in the order of their first appearance in \a Instantane_solide.sommets.
+ *\param I copy of the solid data
+ *\param table coordinates of the distinct vertices (3 per vertex)
+ *\param triangles indices in \a table of the vertices of each triangle (3 per triangle)
+ *\return void
+ */
+void Table_sommets(const Instantane_solide& I, std::vector<double>& table, std::vector<int>& triangles){
+  const int nb_coins = I.sommets.size()/3;
+  if(I.indices.size()!=nb_coins){
+    //Triangles not built from the faces: no shared vertex
+    table = I.sommets;
+    triangles.resize(nb_coins);
+    for(int l=0; l<nb_coins; l++){
+      triangles[l] = l;
+    }
+    return;
+  }
+  triangles = I.indices;
+  table.clear();
+  for(int l=0; l<triangles.size(); l++){
+    if(3*triangles[l]==table.size()){
+      table.insert(table.end(),I.sommets.begin()+3*l,I.sommets.begin()+3*l+3);
+    }
+  }
+}
+
+/*!\brief Output of the solid in file solide<n>.vtk with a table of shared vertices.
+ *\details The kinematics of the particles are written once per particle in the field data of the file (arrays displacement, velocity, e and omega of the size of the number of particles), and the cell array particule gives the index of the particle of each triangle. Binary or ASCII depending on \a sortie_binaire.
+ *\param I copy of the solid data
+ *\return void
+ */
+void Ecrit_instantane_indexe(const Instantane_solide& I){
+  const int nb_part = I.nb_triangles.size();
+  const int nb_triangles = I.sommets.size()/9;
+  std::vector<double> table;
+  std::vector<int> triangles;
+  Table_sommets(I,table,triangles);
+
+  std::ostringstream oss;
+  oss << "resultats/solide" << I.n << ".vtk";
+  std::ofstream vtk(oss.str().c_str(),ios::out|ios::binary);
+  if(!vtk){
+    cout <<"Opening solide" << I.n << ".vtk failed" << endl;
+    return;
+  }
+  vtk << setprecision(15);
+  vtk << "# vtk DataFile Version 3.0" << "\n";
+  vtk << "#Simulation Euler" << "\n";
+  vtk << (sortie_binaire ? "BINARY" : "ASCII") << "\n";
+  vtk << "DATASET UNSTRUCTURED_GRID" << "\n";
+  //Displacement, velocity, rotation vector and angular velocity of each particle
+  const char* noms[4] = {"displacement", "velocity", "e", "omega"};
+  const std::vector<Vecteur_3>* champs[4] = {&I.Dx, &I.u, &I.e, &I.omega};
+  std::vector<double> valeurs(3*nb_part);
+  vtk << "FIELD FieldData 4" << "\n";
+  for(int m=0; m<4; m++){
+    for(int it=0; it<nb_part; it++){
+      for(int c=0; c<3; c++){
+	valeurs[3*it+c] = (*champs[m])[it][c];
+      }
+    }
+    vtk << noms[m] << " 3 " << nb_part << " double" << "\n";
+    Ecrit_tableau_vtk(vtk,valeurs,3,sortie_binaire);
+  }
+  vtk << "POINTS " << table.size()/3 << " double" << "\n";
+  Ecrit_tableau_vtk(vtk,table,3,sortie_binaire);
+  std::vector<int> cellules(4*nb_triangles);
+  for(int l=0; l<nb_triangles; l++){
+    cellules[4*l] = 3;
+    cellules[4*l+1] = triangles[3*l];
+    cellules[4*l+2] = triangles[3*l+1];
+    cellules[4*l+3] = triangles[3*l+2];
+  }
+  vtk << "CELLS " << nb_triangles << " " << 4*nb_triangles << "\n";
+  Ecrit_tableau_vtk(vtk,cellules,4,sortie_binaire);
+  vtk << "CELL_TYPES " << nb_triangles << "\n";
+  Ecrit_tableau_vtk(vtk,std::vector<int>(nb_triangles,5),1,sortie_binaire);
+  vtk << "CELL_DATA " << nb_triangles << "\n";
+  vtk << "SCALARS particule int 1" << "\n";
+  vtk << "LOOKUP_TABLE default" << "\n";
+  std::vector<int> particules;
+  particules.reserve(nb_triangles);
   for(int it=0; it<nb_part; it++){
-    nb_triangles += solide[it].triangles.size();
+    particules.insert(particules.end(),I.nb_triangles[it],it);
   }
+  Ecrit_tableau_vtk(vtk,particules,1,sortie_binaire);
+  vtk.close();
+}
+
+/*!\brief Appends the positions of the vertices of \a I to resultats/solide_trajectoire.bin.
+ *\details The file is created again, or completed on a restart (the first record is then a key frame).
+ *\param I copy of the solid data
+ *\param t time of the output
+ *\return void
+ */
+void Trajectoire_solide::Ajoute(const Instantane_solide& I, const double t){
+  if(!fichier.is_open()){
+    fichier.open("resultats/solide_trajectoire.bin",reprise ? ios::out|ios::app|ios::binary : ios::out|ios::binary);
+    if(!fichier){
+      cout << "Opening of 'solide_trajectoire.bin' failed" << endl;
+      return;
+    }
+    if(fichier.tellp()==0){
+      Ecrit_entete_serie(fichier,"CELIA3DT",2,0);
+    }
+  }
+  std::vector<double> table;
+  std::vector<int> triangles_table;
+  Table_sommets(I,table,triangles_table);
+  const int nb_sommets = table.size()/3;
+  const int cle = (nb_enregistrements%periode_cle_solide==0 || triangles_table!=triangles) ? 0 : 1;
+  fichier.write(reinterpret_cast<const char*>(&I.n),sizeof(int));
+  fichier.write(reinterpret_cast<const char*>(&t),sizeof(double));
+  fichier.write(reinterpret_cast<const char*>(&cle),sizeof(int));
+  fichier.write(reinterpret_cast<const char*>(&nb_sommets),sizeof(int));
+  if(cle==0){
+    fichier.write(reinterpret_cast<const char*>(table.data()),table.size()*sizeof(double));
+    positions.swap(table);
+    triangles.swap(triangles_table);
+  }
+  else{
+    std::vector<float> differences(table.size());
+    for(int l=0; l<table.size(); l++){
+      differences[l] = float(table[l]-positions[l]);
+      positions[l] += differences[l];
+    }
+    fichier.write(reinterpret_cast<const char*>(differences.data()),differences.size()*sizeof(float));
+  }
+  fichier.flush();
+  nb_enregistrements++;
+}
+
+/*!\brief Output of the solid in file solide<n>.vtk.
+ *\details Only \a I is used, so that the writing can be done by \a Ecriture_asynchrone while the computation goes on. With \a sortie_solide_indexee, see \a Ecrit_instantane_indexe; otherwise, the three vertices and the kinematics of the particle are written for each triangle, in ASCII.
+ *\param I copy of the solid data
+ *\return void
+ */
+void Ecrit_instantane(const Instantane_solide& I){ 
+  if(sortie_solide_indexee){
+    Ecrit_instantane_indexe(I);
+    return;
+  }
+  const int nb_part = I.nb_triangles.size();
+  const int nb_triangles = I.sommets.size()/9;
 
   std::ostringstream oss;
-  oss << "resultats/solide" << n << ".vtk";
+  oss << "resultats/solide" << I.n << ".vtk";
   string s = oss.str();
   const char* const solidevtk = s.c_str();
 	
@@ -2542,226 +3161,144 @@ void Solide::Impression(int n){
   std::ofstream vtk;
   vtk.open(solidevtk,ios::out);
   if(!vtk.is_open()){
-    cout <<"Opening solide" << n << ".vtk failed" << endl;
+    cout <<"Opening solide" << I.n << ".vtk failed" << endl;
   }
   vtk << setprecision(15);
   //Initialization of the vtk file
-  vtk << "# vtk DataFile Version 3.0" << endl;
-  vtk << "#Simulation Euler" << endl;
-  vtk << "ASCII" << endl;
+  vtk << "# vtk DataFile Version 3.0" << "\n";
+  vtk << "#Simulation Euler" << "\n";
+  vtk << "ASCII" << "\n";
   vtk<<"\n";
-  vtk << "DATASET UNSTRUCTURED_GRID" << endl;
-  vtk << "POINTS " << 3*nb_triangles << " DOUBLE" << endl;
-	
-  for(int it=0; it<nb_part; it++){
-    for(int l= 0; l<solide[it].triangles.size(); l++){
-      vtk << solide[it].triangles[l].operator[](0).operator[](0) << " " << solide[it].triangles[l].operator[](0).operator[](1) << " " << solide[it].triangles[l].operator[](0).operator[](2) << endl;
-      vtk << solide[it].triangles[l].operator[](1).operator[](0) << " " << solide[it].triangles[l].operator[](1).operator[](1) << " " << solide[it].triangles[l].operator[](1).operator[](2) << endl;
-      vtk << solide[it].triangles[l].operator[](2).operator[](0) << " " << solide[it].triangles[l].operator[](2).operator[](1) << " " << solide[it].triangles[l].operator[](2).operator[](2) << endl;
-    }
+  vtk << "DATASET UNSTRUCTURED_GRID" << "\n";
+  vtk << "POINTS " << 3*nb_triangles << " DOUBLE" << "\n";
+  for(int l=0; l<3*nb_triangles; l++){
+    vtk << I.sommets[3*l] << " " << I.sommets[3*l+1] << " " << I.sommets[3*l+2] << "\n";
   }
   vtk<<"\n";
-  vtk << "CELLS " << nb_triangles << " " << 4*nb_triangles<< endl;
-  int num=0;
-  for(int it=0; it<nb_part; it++){
-    for(int l= 0; l<solide[it].triangles.size(); l++){
-      vtk << 3 << " " << 3*num << " " << 3*num+1 << " " << 3*num+2 << endl;
-      num++;
-    }
+  vtk << "CELLS " << nb_triangles << " " << 4*nb_triangles<< "\n";
+  for(int num=0; num<nb_triangles; num++){
+    vtk << 3 << " " << 3*num << " " << 3*num+1 << " " << 3*num+2 << "\n";
   }
   vtk << "\n";
-  vtk << "CELL_TYPES " << nb_triangles << endl;
+  vtk << "CELL_TYPES " << nb_triangles << "\n";
   for(int l= 0; l<nb_triangles; l++)
   {
-    vtk << 5 << endl;
-  }
-  vtk << "\n";
-  vtk << "CELL_DATA " << nb_triangles << endl;
-  //Displacement
-  vtk << "VECTORS displacement double" << endl;
-  //vtk << "LOOKUP_TABLE default" << endl;
-  for(int it=0; it<nb_part; it++){
-    for(int l= 0; l<solide[it].triangles.size(); l++)
-    {
-      vtk << solide[it].Dx.operator[](0) << " " << solide[it].Dx.operator[](1) << " " << solide[it].Dx.operator[](2) << endl;
-    }
-  }
-  vtk << "\n";
-  //Velocity
-  vtk << "VECTORS velocity double" << endl;
-  //vtk << "LOOKUP_TABLE default" << endl;
-  for(int it=0; it<nb_part; it++){
-    for(int l= 0; l<solide[it].triangles.size(); l++)
-    {
-      vtk << solide[it].u.operator[](0) << " " << solide[it].u.operator[](1) << " " << solide[it].u.operator[](2) << endl;
-    }
+    vtk << 5 << "\n";
   }
   vtk << "\n";
-  //Rotation vector
-  vtk << "VECTORS e double" << endl;
-  //vtk << "LOOKUP_TABLE default" << endl;
-  for(int it=0; it<nb_part; it++){
-    for(int l= 0; l<solide[it].triangles.size(); l++)
-    {
-      vtk << solide[it].e.operator[](0) << " " << solide[it].e.operator[](1) << " " << solide[it].e.operator[](2) << endl;
-    }
-  }
-  vtk << "\n";
-  //Angular velocity
-  vtk << "VECTORS omega double" << endl;
-  //vtk << "LOOKUP_TABLE default" << endl;
-  for(int it=0; it<nb_part; it++){
-    for(int l= 0; l<solide[it].triangles.size(); l++)
-    {
-      vtk << solide[it].omega.operator[](0) << " " << solide[it].omega.operator[](1) << " " << solide[it].omega.operator[](2) << endl;
+  vtk << "CELL_DATA " << nb_triangles << "\n";
+  //Displacement, velocity, rotation vector and angular velocity
+  const char* noms[4] = {"displacement", "velocity", "e", "omega"};
+  const std::vector<Vecteur_3>* champs[4] = {&I.Dx, &I.u, &I.e, &I.omega};
+  for(int m=0; m<4; m++){
+    vtk << "VECTORS " << noms[m] << " double" << "\n";
+    for(int it=0; it<nb_part; it++){
+      const Vecteur_3& V = (*champs[m])[it];
+      for(int l= 0; l<I.nb_triangles[it]; l++)
+      {
+	vtk << V[0] << " " << V[1] << " " << V[2] << "\n";
+      }
     }
+    vtk << "\n";
   }
-  vtk << "\n";
   vtk.close();
 }
 
 /*!\brief Simple breaking criterion for fracture tests
-  \detailed A maximum elongation is allowed, after which the particle link is broken.
+  \detailed A maximum elongation is allowed, after which the particle link is broken. The elongations of all the links are computed first, then the breaks are applied in the order of \a Solide.liens and added to \a Solide.ruptures.
 */
 void Solide::breaking_criterion(){
-  for(int it=0; it<solide.size(); it++){
-    for(int i=0; i<solide[it].faces.size(); i++){
-      if(solide[it].faces[i].voisin >= 0){
-	for(int iter=0; iter<solide.size(); iter++){
-	  if(it!=iter){
-	    if(solide[it].faces[i].voisin == iter){
-	      double distance = sqrt(CGAL::to_double(CGAL::squared_distance(Point_3(solide[it].Dx.x() + solide[it].x0.x(), solide[it].Dx.y() + solide[it].x0.y(), solide[it].Dx.z() + solide[it].x0.z())  ,Point_3(solide[iter].Dx.x() + solide[iter].x0.x(),solide[iter].Dx.y() + solide[iter].x0.y(), solide[iter].Dx.z() + solide[iter].x0.z()) )));
-	      if( (distance - solide[it].faces[i].D0)/solide[it].faces[i].D0 >= k_max){
-		cout<<"BREAK!!!!"<<endl;
-		solide[it].faces[i].voisin = -2;
-		int j;
-		for(int f=0; f<solide[iter].faces.size(); f++){ //
-		  if(solide[iter].faces[f].voisin == it){
-		    solide[iter].faces[f].voisin = -2;
-		    j=f;
-		  }
-		}
-		for(int count=0; count<solide[it].faces.size() ; count++){
-		  for(int ii=0; ii<solide[it].faces[count].vertex.size(); ii++)
-		  { 
-		    std::vector<int> particules;
-		    for(int part=0; part<solide[it].faces[count].vertex[ii].particules.size(); part++){
-		      if(solide[it].faces[count].vertex[ii].particules[part] != iter){
-			particules.push_back(solide[it].faces[count].vertex[ii].particules[part]);
-		      }
-		    }
-		    solide[it].faces[count].vertex[ii].particules.erase(solide[it].faces[count].vertex[ii].particules.begin(),
-									solide[it].faces[count].vertex[ii].particules.end());
-		    solide[it].faces[count].vertex[ii].particules = particules;
-																																					
-		  }
-		}
-		for(int count=0; count<solide[iter].faces.size() ; count++){
-		  for(int ii=0; ii<solide[iter].faces[count].vertex.size(); ii++)
-		  { 
-		    std::vector<int> particules;
-		    for(int part=0; part<solide[iter].faces[count].vertex[ii].particules.size(); part++){
-		      if(solide[iter].faces[count].vertex[ii].particules[part] != it){
-			particules.push_back(solide[iter].faces[count].vertex[ii].particules[part]);
-		      }
-		    }
-		    solide[iter].faces[count].vertex[ii].particules.erase(solide[iter].faces[count].vertex[ii].particules.begin(),
-									  solide[iter].faces[count].vertex[ii].particules.end());
-		    solide[iter].faces[count].vertex[ii].particules = particules;
-		  }
-		}
-		for(int count=0; count<solide.size() ; count++){
-		  if(count != it && count != iter){
-		    bool voisin_it = false;
-		    for(int jj=0; jj<solide[count].faces.size() ; jj++){
-		      if(solide[count].faces[jj].voisin==it){
-			voisin_it=true;
-		      }
-		    }
-		    if(!voisin_it){
-		      for(int kk=0; kk<solide[it].faces[i].size() ; kk++){
-			for(int jj=0; jj<solide[count].faces.size() ; jj++){
-			  for(int ii=0; ii<solide[count].faces[jj].vertex.size(); ii++)
-			  {   
-			    if(solide[it].faces[i].vertex[kk].num == solide[count].faces[jj].vertex[ii].num){
-			      std::vector<int> particules;
-			      for(int part=0; part<solide[count].faces[jj].vertex[ii].particules.size(); part++){
-				if(solide[count].faces[jj].vertex[ii].particules[part] != it){
-				  particules.push_back(solide[count].faces[jj].vertex[ii].particules[part]);
-				}
-			      }
-			      solide[count].faces[jj].vertex[ii].particules.erase(solide[count].faces[jj].vertex[ii].particules.begin(), solide[count].faces[jj].vertex[ii].particules.end());
-			      solide[count].faces[jj].vertex[ii].particules = particules;
-			    }
-			  }
-			}
-		      }
-		      for(int kk=0; kk<solide[it].faces[i].size() ; kk++){
-			for(int jj=0; jj<solide[it].faces.size() ; jj++){
-			  for(int ii=0; ii<solide[it].faces[jj].vertex.size(); ii++)
-			  {   
-			    if(solide[it].faces[i].vertex[kk].num == solide[it].faces[jj].vertex[ii].num){
-			      std::vector<int> particules;
-			      for(int part=0; part<solide[it].faces[jj].vertex[ii].particules.size(); part++){
-				if(solide[it].faces[jj].vertex[ii].particules[part] != count){
-				  particules.push_back(solide[it].faces[jj].vertex[ii].particules[part]);
-				}
-			      }
-			      solide[it].faces[jj].vertex[ii].particules.erase(solide[it].faces[jj].vertex[ii].particules.begin(), solide[it].faces[jj].vertex[ii].particules.end());
-			      solide[it].faces[jj].vertex[ii].particules = particules;
-			    }
-			  }
-			}
-		      }
-		    }
-		    bool voisin_iter = false;
-		    for(int jj=0; jj<solide[count].faces.size() ; jj++){
-		      if(solide[count].faces[jj].voisin == iter){
-			voisin_iter=true;
-		      }
-		    }
-		    if(!voisin_iter){
-		      for(int kk=0; kk<solide[iter].faces[j].size() ; kk++){
-			for(int jj=0; jj<solide[count].faces.size() ; jj++){
-			  for(int ii=0; ii<solide[count].faces[jj].vertex.size(); ii++)
-			  {   
-			    if(solide[iter].faces[j].vertex[kk].num == solide[count].faces[jj].vertex[ii].num){
-			      std::vector<int> particules;
-			      for(int part=0; part<solide[count].faces[jj].vertex[ii].particules.size(); part++){
-				if(solide[count].faces[jj].vertex[ii].particules[part] != iter){
-				  particules.push_back(solide[count].faces[jj].vertex[ii].particules[part]);
-				}
-			      }
-			      solide[count].faces[jj].vertex[ii].particules.erase(solide[count].faces[jj].vertex[ii].particules.begin(), solide[count].faces[jj].vertex[ii].particules.end());
-			      solide[count].faces[jj].vertex[ii].particules = particules;
-			    }
-			  }
-			}
-		      }
-		      for(int kk=0; kk<solide[iter].faces[j].size() ; kk++){
-			for(int jj=0; jj<solide[iter].faces.size() ; jj++){
-			  for(int ii=0; ii<solide[iter].faces[jj].vertex.size(); ii++)
-			  {   
-			    if(solide[iter].faces[j].vertex[kk].num == solide[iter].faces[jj].vertex[ii].num){
-			      std::vector<int> particules;
-			      for(int part=0; part<solide[iter].faces[jj].vertex[ii].particules.size(); part++){
-				if(solide[iter].faces[jj].vertex[ii].particules[part] != count){
-				  particules.push_back(solide[iter].faces[jj].vertex[ii].particules[part]);
-				}
-			      }
-			      solide[iter].faces[jj].vertex[ii].particules.erase(solide[iter].faces[jj].vertex[ii].particules.begin(), solide[iter].faces[jj].vertex[ii].particules.end());
-			      solide[iter].faces[jj].vertex[ii].particules = particules;
-			    }
-			  }
-			}
-		      }
-		    }
-		    
-		  }
-		}
-									  
-	      } 
-	    }
+  const int nb_ruptures_prev = ruptures.size();
+  const int nb_liens = liens.size();
+  std::vector<double> allongement(nb_liens,0.);
+#pragma omp parallel for schedule(static)
+  for(int l=0; l<nb_liens; l++){
+    const Lien& L = liens[l];
+    if(L.actif){
+      Vecteur_3 X1X2 = L.X0iX0j + solide[L.j].Dx - solide[L.i].Dx;
+      allongement[l] = (sqrt(X1X2.squared_length()) - L.D0)/L.D0;
+    }
+  }
+  for(int l=0; l<nb_liens; l++){
+    if(liens[l].actif && allongement[l] >= k_max){
+      Rupture R;
+      R.lien = l;
+      R.i = liens[l].i;
+      R.j = liens[l].j;
+      R.allongement = allongement[l];
+      ruptures.push_back(R);
+      Rupture_lien(l);
+    }
+  }
+  if(ruptures.size()>nb_ruptures_prev){
+    JOURNAL(journal_pas_de_temps,journal_resume)<<"BREAK!!!! "<<ruptures.size()-nb_ruptures_prev<<" broken link(s)"<<"\n";
+  }
+}
+
+/*!\brief Test if two particles are linked.
+ *\param p index of the first particle
+ *\param q index of the second particle
+ *\return bool
+ */
+bool Solide::Lies(const int p, const int q){
+  for(int k=0; k<liens_particule[p].size(); k++){
+    const Lien& L = liens[liens_particule[p][k]];
+    if(L.actif && (L.i == q || L.j == q)){
+      return true;
+    }
+  }
+  return false;
+}
+
+//! Remove particle q from a list of particles sharing a vertex
+static void retire_particule(std::vector<int>& particules, const int q){
+  particules.erase(std::remove(particules.begin(),particules.end(),q),particules.end());
+}
+
+/*!\brief Break a link.
+ *\details The common faces become in contact with void (\a Face.voisin = -2), the two particles do not share their vertices anymore, and the particles which are not linked to one of them do not share the vertices of the broken face with it anymore (see \a Solide.Separe_sommets). 
+ *\param l index of the link in \a Solide.liens
+ *\return void
+ */
+void Solide::Rupture_lien(const int l){
+  Lien& L = liens[l];
+  const int it = L.i;
+  const int iter = L.j;
+  L.actif = false;
+  nb_ruptures++;
+  liens_rompus.push_back(l);
+  solide[it].faces[L.fi].voisin = -2;
+  solide[iter].faces[L.fj].voisin = -2;
+  for(int f=0; f<solide[it].faces.size(); f++){
+    for(int k=0; k<solide[it].faces[f].size(); k++){
+      retire_particule(solide[it].faces[f].vertex[k].particules, iter);
+    }
+  }
+  for(int f=0; f<solide[iter].faces.size(); f++){
+    for(int k=0; k<solide[iter].faces[f].size(); k++){
+      retire_particule(solide[iter].faces[f].vertex[k].particules, it);
+    }
+  }
+  Separe_sommets(it, L.fi, iter);
+  Separe_sommets(iter, L.fj, it);
+}
+
+/*!\brief Separate particle p from the particles which are not linked to it on the vertices of its face f.
+ *\param p index of the particle
+ *\param f index of the broken face of p
+ *\param q index of the particle on the other side of the broken face
+ *\return void
+ */
+void Solide::Separe_sommets(const int p, const int f, const int q){
+  for(int k=0; k<solide[p].faces[f].size(); k++){
+    const std::vector<Position_sommet>& pos = sommets[solide[p].faces[f].vertex[k].num];
+    for(int n=0; n<pos.size(); n++){
+      const int count = pos[n].particule;
+      if(count != p && count != q && !Lies(count,p)){
+	retire_particule(solide[count].faces[pos[n].face].vertex[pos[n].sommet].particules, p);
+	for(int m=0; m<pos.size(); m++){
+	  if(pos[m].particule == p){
+	    retire_particule(solide[p].faces[pos[m].face].vertex[pos[m].sommet].particules, count);
 	  }
 	}
       }
@@ -25,9 +25,68 @@
  */
 
 #include "intersections.hpp"
+#include <fstream>
 #ifndef SOLIDE_HPP
 #define SOLIDE_HPP
 
+/*! \brief Double-precision 3d vector for the kinematics of the particles.
+  \details The dynamics of the particles does not need exact arithmetic, whereas each operation on a \a Vector_3 of the exact kernel builds a lazy evaluation node. The kinematic quantities of \a Particule are stored as \a Vecteur_3, and converted with \a Vecteur_3.vector_3() where the coupling geometry needs exact types.
+*/
+class Vecteur_3
+{
+public:
+  Vecteur_3(){ v[0] = v[1] = v[2] = 0.; }
+  Vecteur_3(const double x, const double y, const double z){ v[0] = x; v[1] = y; v[2] = z; }
+  Vecteur_3(const Vector_3& w){ 
+    v[0] = CGAL::to_double(w.x()); v[1] = CGAL::to_double(w.y()); v[2] = CGAL::to_double(w.z()); 
+  }
+  Vector_3 vector_3() const { return Vector_3(v[0],v[1],v[2]); } //!< Conversion to the exact kernel
+  double operator[](const int i) const { return v[i]; }
+  double& operator[](const int i) { return v[i]; }
+  double x() const { return v[0]; }
+  double y() const { return v[1]; }
+  double z() const { return v[2]; }
+  double squared_length() const { return v[0]*v[0]+v[1]*v[1]+v[2]*v[2]; }
+  Vecteur_3 operator+(const Vecteur_3& w) const { return Vecteur_3(v[0]+w.v[0],v[1]+w.v[1],v[2]+w.v[2]); }
+  Vecteur_3 operator-(const Vecteur_3& w) const { return Vecteur_3(v[0]-w.v[0],v[1]-w.v[1],v[2]-w.v[2]); }
+  Vecteur_3 operator-() const { return Vecteur_3(-v[0],-v[1],-v[2]); }
+  Vecteur_3 operator*(const double a) const { return Vecteur_3(a*v[0],a*v[1],a*v[2]); }
+  Vecteur_3 operator/(const double a) const { return Vecteur_3(v[0]/a,v[1]/a,v[2]/a); }
+  double operator*(const Vecteur_3& w) const { return v[0]*w.v[0]+v[1]*w.v[1]+v[2]*w.v[2]; } //!< Scalar product
+  Vecteur_3& operator+=(const Vecteur_3& w){ v[0] += w.v[0]; v[1] += w.v[1]; v[2] += w.v[2]; return *this; }
+  Vecteur_3& operator-=(const Vecteur_3& w){ v[0] -= w.v[0]; v[1] -= w.v[1]; v[2] -= w.v[2]; return *this; }
+  double v[3]; //!< Components
+};
+
+inline Vecteur_3 operator*(const double a, const Vecteur_3& w){ return w*a; }
+inline Vecteur_3 cross_product(const Vecteur_3& a, const Vecteur_3& b){
+  return Vecteur_3(a[1]*b[2]-a[2]*b[1], a[2]*b[0]-a[0]*b[2], a[0]*b[1]-a[1]*b[0]);
+}
+inline std::ostream& operator<<(std::ostream& out, const Vecteur_3& w){
+  return out << w[0] << " " << w[1] << " " << w[2];
+}
+
+/*! \brief Compensated summation of doubles (Neumaier's variant of Kahan's algorithm).
+ */
+class Somme_compensee
+{
+public:
+  Somme_compensee() : s(0.), c(0.) {}
+  void ajoute(const double x){
+    const double t = s + x;
+    if(std::abs(s) >= std::abs(x)){
+      c += (s - t) + x;
+    } else {
+      c += (x - t) + s;
+    }
+    s = t;
+  }
+  void ajoute(const Somme_compensee& a){ ajoute(a.s); ajoute(a.c); }
+  double valeur() const { return s + c; }
+  double s; //!< Sum
+  double c; //!< Compensation of the rounding errors
+};
+
 //! Vertex class
 class Vertex 
 {
@@ -94,6 +153,14 @@ public:
   void Volume_libre();
   void solve_position(double dt);
   void solve_vitesse(double dt);
+  void Mise_a_jour_rotation();
+  //! Image of vector v by the rotation of \a Particule.mvt_t
+  Vecteur_3 rotation(const Vecteur_3& v) const {
+    return Vecteur_3(rot_t[0][0]*v[0]+rot_t[0][1]*v[1]+rot_t[0][2]*v[2],
+		     rot_t[1][0]*v[0]+rot_t[1][1]*v[1]+rot_t[1][2]*v[2],
+		     rot_t[2][0]*v[0]+rot_t[2][1]*v[1]+rot_t[2][2]*v[2]);
+  }
+  double Energie_cinetique();
   Vector_3 vitesse_parois(const Point_3& X_f);  
   Vector_3 vitesse_parois_prev(const Point_3& X_f);
   bool cube; //!< = true if the particle is a cube, false otherwise
@@ -161,36 +228,128 @@ public:
   double I[3]; //!< Inertia matrix of the particle
   double rotref[3][3]; //!<Rotation matrix \f$ Q_0 \f$ such that the inertia matrix \f$ R \f$ in the reference frame can be written :\f$ R = Q_0 R_0 Q_0^{-1}\f$, with \f$R_0=diag(I_1,I_2,I_3)\f$.
   Point_3 x0; //!<Position of the particle center at t=0
-  Vector_3 Dx; //!<Displacement of the particle center at time t
-  Vector_3 Dxprev; //!<Displacement of the particle center at time t-dt
-  Vector_3 Fi; //!<Solid internal forces
+  Vecteur_3 Dx; //!<Displacement of the particle center at time t
+  Vecteur_3 Dxprev; //!<Displacement of the particle center at time t-dt
+  Vecteur_3 Fi; //!<Solid internal forces
   /*! 
    * \warning  <b> Specific coupling parameter ! </b>
    */
-  Vector_3 Ff; //!<Fluid forces applied on the solid between times t and t+dt/2
+  Vecteur_3 Ff; //!<Fluid forces applied on the solid between times t and t+dt/2
   /*! 
    * \warning  <b> Specific coupling parameter ! </b>
    */
-  Vector_3 Ffprev; //!< Fluid forces applied on the solide between times t-dt/2 and t
-  Vector_3 Mi; //!< Interior torques of the solid
+  Vecteur_3 Ffprev; //!< Fluid forces applied on the solide between times t-dt/2 and t
+  Vecteur_3 Mi; //!< Interior torques of the solid
   /*! 
    * \warning  <b> Specific coupling parameter ! </b>
    */
-  Vector_3 Mf; //!< Fluid torques applied on the solid between times t and t+dt/2
+  Vecteur_3 Mf; //!< Fluid torques applied on the solid between times t and t+dt/2
   /*! 
    * \warning  <b> Specific coupling parameter ! </b>
    */
-  Vector_3 Mfprev; //!< FLuid torques applied on the solid between times t-dt/2 and t
-  Vector_3 u; //!< Particle velocity at time t
-  Vector_3 u_half; //!< Particle velocity at time t-dt/2
-  Vector_3 omega; //!< Angular velocity at time t
-  Vector_3 omega_half;//!< Angular velocity at time t-dt/2
-  Vector_3 e; //!<Rotation vector at time t
-  Vector_3 eprev; //!<Rotation vector at time t-dt
+  Vecteur_3 Mfprev; //!< FLuid torques applied on the solid between times t-dt/2 and t
+  Vecteur_3 u; //!< Particle velocity at time t
+  Vecteur_3 u_half; //!< Particle velocity at time t-dt/2
+  Vecteur_3 omega; //!< Angular velocity at time t
+  Vecteur_3 omega_half;//!< Angular velocity at time t-dt/2
+  Vecteur_3 e; //!<Rotation vector at time t
+  Vecteur_3 eprev; //!<Rotation vector at time t-dt
+  double rot_t[3][3]; //!<Rotation matrix of \a Particule.mvt_t (double precision)
+  double Q_t[3][3]; //!<Total rotation matrix from the inertial frame to the current frame at time t, computed from \a Particule.e (see \a Particule.Mise_a_jour_rotation)
+  double quaternion[4]; //!<Unit quaternion \f$ (e_0, e) \f$ of the rotation at time t
   Aff_transformation_3 mvt_t; //!<Affine transformation associated with the rigid body movement of the particle at time t
   Aff_transformation_3 mvt_tprev; //!<Affine transformation associated with the rigid body movement of the particle at time t-dt
 }; 
 
+/*! \brief Kinematic state of a particle.
+  \details Snapshot of the members of \a Particule modified by \a Particule.solve_position, used to restore a particle without copying its geometry.
+  \warning <b> Specific coupling class ! </b>
+*/
+class Etat_cinematique
+{
+public:
+  Vecteur_3 Dx, Dxprev;                 //!< Displacement of the particle center at times t and t-dt
+  Vecteur_3 u, u_half;                  //!< Particle velocity at times t and t-dt/2
+  Vecteur_3 omega, omega_half;          //!< Angular velocity at times t and t-dt/2
+  Vecteur_3 e, eprev;                   //!< Rotation vector at times t and t-dt
+  Vecteur_3 Ff, Ffprev, Mf, Mfprev;     //!< Fluid forces and torques
+  Vecteur_3 Fi, Mi;                     //!< Internal forces and torques
+  double epsilon;                      //!< Volumetric deformation
+  Aff_transformation_3 mvt_t, mvt_tprev; //!< Rigid body movement at times t and t-dt
+  double rot_t[3][3], Q_t[3][3], quaternion[4]; //!< Rotation matrices and quaternion at time t
+  Bbox bbox;                           //!< Bounding box of the particle
+  std::vector<int> voisin;             //!< \a Face.voisin of the particle faces
+};
+
+/*! \brief Kinematic state of a \a Solide (see \a Solide.Sauvegarde and \a Solide.Restauration).
+  \warning <b> Specific coupling class ! </b>
+*/
+class Etat_solide
+{
+public:
+  std::vector<Etat_cinematique> solide; //!< State of each particle
+  int nb_positions;                     //!< Value of \a Solide.nb_positions at the snapshot
+  int nb_ruptures;                      //!< Value of \a Solide.nb_ruptures at the snapshot
+};
+
+/*! \brief Link between two bonded particles.
+  \details Each link is shared by two particles and evaluated once per time-step (see \a Solide.Forces_internes). The geometric quantities of the common face are stored in the reference configuration.
+*/
+class Lien
+{
+public:
+  Lien();
+  Lien(const Particule& P1, int i1, int f1, const Particule& P2, int i2, int f2);
+  int i;          //!< Index of the first particle
+  int fi;         //!< Index of the common face in the first particle
+  int j;          //!< Index of the second particle
+  int fj;         //!< Index of the common face in the second particle
+  bool actif;     //!< =false if the link is broken
+  double S;       //!< Area of the common face
+  double D0;      //!< Equilibrium distance between the two particles
+  double alpha;   //!< Interpolation weight of the volumetric deformation of the first particle
+  double alphan;  //!< Flexion/torsion stiffness along the face normal
+  double alphas;  //!< Flexion/torsion stiffness along \a Face.s
+  double alphat;  //!< Flexion/torsion stiffness along \a Face.t
+  Vecteur_3 Sni;  //!< Area vector of the common face, oriented by the first particle
+  Vecteur_3 Snj;  //!< Area vector of the common face, oriented by the second particle
+  Vecteur_3 X0iX0j; //!< Vector between the initial centers of the two particles
+  Vecteur_3 XCi;  //!< Vector from the center of the first particle to the face center
+  Vecteur_3 XCj;  //!< Vector from the center of the second particle to the face center
+  Vecteur_3 normale, s, t; //!< Local axes of the common face (first particle)
+};
+
+//! Position of a vertex in the faces of a particle
+struct Position_sommet
+{
+  int particule; //!< Index of the particle
+  int face;      //!< Index of the face in \a Particule.faces
+  int sommet;    //!< Index of the vertex in \a Face.vertex
+};
+
+//! Broken link event (see \a Solide.breaking_criterion)
+struct Rupture
+{
+  int lien;           //!< Index of the link in \a Solide.liens
+  int i;              //!< Index of the first particle
+  int j;              //!< Index of the second particle
+  double allongement; //!< Relative elongation of the link at the break
+};
+
+//! Copy of the solid data written in an output file (see \a Solide.Instantane)
+struct Instantane_solide
+{
+  int n;                          //!< Index of the output
+  std::vector<int> nb_triangles;  //!< Number of triangles of each particle
+  std::vector<double> sommets;    //!< Coordinates of the vertices of the triangles (9 per triangle)
+  std::vector<int> indices;       //!< Index of the distinct vertex of each vertex of the triangles (3 per triangle), from the mesh vertex and the particles sharing it
+  std::vector<Vecteur_3> Dx;      //!< Displacement of each particle
+  std::vector<Vecteur_3> u;       //!< Velocity of each particle
+  std::vector<Vecteur_3> e;       //!< Rotation vector of each particle
+  std::vector<Vecteur_3> omega;   //!< Angular velocity of each particle
+  std::vector<Vecteur_3> centres; //!< Position of the center of each particle
+};
+
 //! Solide class
 class Solide
 {
@@ -206,24 +365,85 @@ public:
     return solide.size();
   }
   void Impression(int n);
+  void Instantane(Instantane_solide& I, const int n);
   void Init(const char* s);
-  void Solve_position(double dt);
+  void Solve_position(double dt, const int n_sub = 1);
   void Solve_vitesse(double dt);
+  void Init_liens();
+  void Deformation_volumique();
   void Forces_internes();
   void update_triangles();
+  Vecteur_3 Deplacement_relatif(const Lien& L);
+  Vecteur_3 Position_vertex(const Vertex& V);
   void breaking_criterion();
+  bool Lies(const int p, const int q);
+  void Rupture_lien(const int l);
+  void Separe_sommets(const int p, const int f, const int q);
   double Energie();
   double Energie_potentielle();
   double Energie_cinetique();
   double pas_temps(double t, double T);
+  void Sauvegarde(Etat_solide& etat);
+  bool Restauration(const Etat_solide& etat);
   // private :
   std::vector<Particule> solide; //!< Solid mesh
+  std::vector<Lien> liens; //!< List of the links between particles
+  std::vector< std::vector<int> > liens_particule; //!< Indices (in increasing order) of the links of each particle
+  std::vector< std::vector<Position_sommet> > sommets; //!< Positions of each vertex of the mesh (indexed by \a Vertex.num) in the particle faces
+  std::vector< std::vector<int> > particules_sommets; //!< Particles containing each vertex of the mesh (indexed by \a Vertex.num)
+  std::vector<Vecteur_3> coordonnees_sommets; //!< Initial coordinates of each vertex of the mesh
+  std::vector< std::vector<Vecteur_3> > positions_sommets; //!< Position of each vertex of the mesh moved by each particle of \a Solide.particules_sommets (see \a Solide.update_triangles)
+  std::vector<Rupture> ruptures; //!< Links broken during the last call to \a Solide.Solve_position
+  int nb_positions; //!< Number of calls to \a Solide.Solve_position
+  int nb_ruptures;  //!< Number of broken links
+  std::vector<int> liens_rompus; //!< Indices of the broken links, in the order of the breaks
+};
+
+/*! \brief Dynamic Aitken relaxation of the semi-implicit fixed-point procedure.
+  \details The unknowns of the fixed point are the fluid forces and torques (\a Particule.Ff and \a Particule.Mf) of all the particles. 
+  \warning <b> Specific coupling class ! </b>
+*/
+class Relaxation_Aitken
+{
+public:
+  Relaxation_Aitken();
+  void Relaxation(Solide& S1, Solide& S2, const int k);
+  void Fin(const int k);
+  void Affiche_histogramme(std::ostream& out);
+  double omega;                    //!< Current relaxation factor
+  double omega_prev;               //!< Last relaxation factor of the previous time-step
+  std::vector<double> F;           //!< Forces and torques used at the current iteration
+  std::vector<double> F0;          //!< Forces and torques evaluated at the first iteration of the time-step
+  std::vector<double> r_prev;      //!< Residual at the previous iteration
+  std::vector<double> correction;  //!< Difference between the converged and first evaluated forces at the previous time-step
+  std::vector<int> histogramme;    //!< Number of time-steps per number of fixed-point iterations
 };
 
 bool inside_box(const Bbox& cell, const Point_3& P);
 bool box_inside_convex_polygon(const Particule& S, const Bbox& cell);  
 bool inside_convex_polygon(const Particule& S, const Point_3& P);  
+double Somme(const std::vector<double>& v);
+void Ecrit_instantane(const Instantane_solide& I);
+void Table_sommets(const Instantane_solide& I, std::vector<double>& table, std::vector<int>& triangles);
+
+/*!\brief Positions of the solid vertices at each output, in file resultats/solide_trajectoire.bin (delta encoding).
+  \details The file starts with the header of \a Ecrit_entete_serie: "CELIA3DT", the version 2, the byte order marker and 0 columns (records of variable size). Then one record per output: index n, time t, type (0: key frame, 1: differences), number of vertices, and the coordinates of the vertices of \a Table_sommets, in double precision for a key frame, or as single precision differences with the positions of the previous record otherwise. \n
+  The differences are taken with the positions rebuilt by the reader, so that the rounding errors do not accumulate. A key frame is written every \a periode_cle_solide outputs and when the vertex table changes (broken links).
+*/
+class Trajectoire_solide
+{
+public:
+  Trajectoire_solide(const bool reprise): reprise(reprise), nb_enregistrements(0) {}
+  void Ajoute(const Instantane_solide& I, const double t);
+private:
+  bool reprise;                      //!< Restart: the records are appended to the existing file (see \a Tronque_trajectoire)
+  std::ofstream fichier;             //!< File resultats/solide_trajectoire.bin
+  std::vector<double> positions;     //!< Positions of the vertices rebuilt from the previous records
+  std::vector<int> triangles;        //!< Vertex indices of the triangles at the previous record
+  int nb_enregistrements;            //!< Number of records written
+};
 double Error(Solide& S1, Solide& S2);
+double Error(Solide& S1, const Etat_solide& S2);
 void Copy_f_m(Solide& S1, Solide& S2);
 bool box_inside_tetra(const Tetrahedron &tetra, const Bbox& cell);
 bool inside_tetra(const Tetrahedron &tetra, const Point_3& P);
@@ -0,0 +1,238 @@
+//Copyright 2017 Laurent Monasse
+
+/*
+  This file is part of CELIA3D.
+
+  CELIA3D is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  CELIA3D is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with CELIA3D.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+   \file
+   \authors Laurent Monasse and Maria Adela Puscas
+   \brief Point probes in the fluid and sensors on the particles, sampled during the computation.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include "parametres.hpp"
+#include "fluide.hpp"
+#include "solide.hpp"
+#include "reprise.hpp"
+
+#ifndef SONDES_HPP
+#define SONDES_HPP
+
+/*!\brief Point probes in the fluid and sensors on the particles.
+
+The probes are read in file <b> "sondes.dat" </b> (no probe if the file does not exist), one per line, lines starting with # being ignored:
+- \b "POINT" name x y z: pressure, density and velocity of the fluid at point (x,y,z), by trilinear interpolation between the centers of the 8 nearest cells, weighted by their fluid fraction (1-alpha);
+- \b "PARTICULE" name index: fluid force \a Particule.Ff, fluid torque \a Particule.Mf and displacement \a Particule.Dx of the particle;
+- \b "PAS" n: stride in time iterations of the sampling (default \a pas_sondes), the iterations being counted from the start of the simulation, restarts included.
+
+The samples are stored in a buffer of \a taille_tampon_sondes rows, written in one block to resultats/sondes.bin when it is full and at the end of the computation. The file starts with the header of \a Ecrit_entete_serie ("CELIA3DS", version 1, number of columns), followed by the rows of doubles: time, then the values of the probes. The columns are described in resultats/sondes.txt.
+*/
+class Sondes
+{
+public:
+  Sondes(): pas(pas_sondes), nb_colonnes(0), nb_lignes(0) {}
+  ~Sondes(){ Vide(); }
+
+  /*!\brief Reads the probes in \a nom and opens the output files.
+    \details The cells and the weights of the interpolation are computed once, the fluid grid being fixed.
+    \param nom probe file
+    \param Fluide fluid
+    \param S solid
+    \param ajout true to append the samples to resultats/sondes.bin (restart)
+    \return void
+  */
+  void Init(const char* nom, Grille& Fluide, Solide& S, const bool ajout){
+    std::ifstream in(nom,std::ios::in);
+    if(!in){
+      return;
+    }
+    std::ostringstream description;
+    description << "0 temps" << "\n";
+    nb_colonnes = 1;
+    std::string ligne;
+    while(std::getline(in,ligne)){
+      std::istringstream mots(ligne);
+      std::string mot, nom_sonde;
+      if(!(mots >> mot) || mot[0]=='#'){
+	continue;
+      }
+      if(mot=="POINT"){
+	double X[3];
+	if(!(mots >> nom_sonde >> X[0] >> X[1] >> X[2])){
+	  std::cout << "Probe '" << ligne << "' ignored in " << nom << std::endl;
+	  continue;
+	}
+	Point_fluide P;
+	if(!Interpolation(Fluide,X,P)){
+	  std::cout << "Probe " << nom_sonde << " outside of the fluid domain, ignored" << std::endl;
+	  continue;
+	}
+	points.push_back(P);
+	const char* grandeurs[5] = {"p", "rho", "u", "v", "w"};
+	for(int m=0; m<5; m++){
+	  description << nb_colonnes++ << " " << nom_sonde << " " << grandeurs[m] << "\n";
+	}
+      }
+      else if(mot=="PARTICULE"){
+	int it;
+	if(!(mots >> nom_sonde >> it) || it<0 || it>=S.size()){
+	  std::cout << "Probe '" << ligne << "' ignored in " << nom << std::endl;
+	  continue;
+	}
+	particules.push_back(it);
+	const char* grandeurs[9] = {"Ffx", "Ffy", "Ffz", "Mfx", "Mfy", "Mfz", "Dxx", "Dxy", "Dxz"};
+	for(int m=0; m<9; m++){
+	  description << nb_colonnes++ << " " << nom_sonde << " " << grandeurs[m] << "\n";
+	}
+      }
+      else if(mot=="PAS"){
+	mots >> pas;
+	pas = std::max(pas,1);
+      }
+      else{
+	std::cout << "Unknown key word " << mot << " in " << nom << std::endl;
+      }
+    }
+    if(nb_colonnes==1){
+      nb_colonnes = 0;
+      return;
+    }
+    tampon.resize(taille_tampon_sondes*nb_colonnes);
+    std::ofstream txt("resultats/sondes.txt",std::ios::out);
+    txt << description.str();
+    fichier.open("resultats/sondes.bin",ajout ? std::ios::out|std::ios::app|std::ios::binary : std::ios::out|std::ios::binary);
+    if(!fichier){
+      std::cout << "Opening of 'sondes.bin' failed" << std::endl;
+      nb_colonnes = 0;
+      return;
+    }
+    if(!ajout || fichier.tellp()==0){
+      Ecrit_entete_serie(fichier,"CELIA3DS",1,nb_colonnes);
+    }
+  }
+
+  /*!\brief Samples the probes at time iteration \a n (every \a pas iterations).
+    \param Fluide fluid
+    \param S solid
+    \param n time iteration since the start of the simulation (\a Etat_reprise.iteration on a restart)
+    \param t time
+    \return void
+  */
+  void Echantillonne(Grille& Fluide, Solide& S, const int n, const double t){
+    if(nb_colonnes==0 || n%pas!=0){
+      return;
+    }
+    double* valeurs = &tampon[nb_lignes*nb_colonnes];
+    *valeurs++ = t;
+    for(int s=0; s<points.size(); s++){
+      const Point_fluide& P = points[s];
+      double somme[5] = {0., 0., 0., 0., 0.};
+      double poids = 0.;
+      for(int c=0; c<8; c++){
+	const Cellule& C = Fluide.grille[P.i[c]][P.j[c]][P.k[c]];
+	const double w = P.poids[c]*(1.-C.alpha);
+	somme[0] += w*C.p; somme[1] += w*C.rho;
+	somme[2] += w*C.u; somme[3] += w*C.v; somme[4] += w*C.w;
+	poids += w;
+      }
+      for(int m=0; m<5; m++){
+	*valeurs++ = (poids>eps) ? somme[m]/poids : 0.;
+      }
+    }
+    for(int s=0; s<particules.size(); s++){
+      const Particule& P = S.solide[particules[s]];
+      const Vecteur_3* vecteurs[3] = {&P.Ff, &P.Mf, &P.Dx};
+      for(int m=0; m<3; m++){
+	for(int c=0; c<3; c++){
+	  *valeurs++ = (*vecteurs[m])[c];
+	}
+      }
+    }
+    nb_lignes++;
+    if(nb_lignes==taille_tampon_sondes){
+      Vide();
+    }
+  }
+
+  //! \brief Writes the samples of the buffer in resultats/sondes.bin
+  void Vide(){
+    if(nb_lignes>0 && fichier.is_open()){
+      fichier.write(reinterpret_cast<const char*>(tampon.data()),nb_lignes*nb_colonnes*sizeof(double));
+      fichier.flush();
+    }
+    nb_lignes = 0;
+  }
+
+private:
+  //! \brief Cells and weights of the trilinear interpolation at a point
+  struct Point_fluide
+  {
+    int i[8], j[8], k[8]; //!< Indices of the 8 cells
+    double poids[8];      //!< Trilinear weights
+  };
+
+  /*!\brief Cells and weights of the trilinear interpolation at point \a X.
+    \details The cell containing \a X is found with \a Grille.in_cell, then the interpolation uses the cells whose centers surround \a X (ghost cells included near the boundary).
+    \return bool: false if \a X is outside of the fluid domain
+  */
+  static bool Interpolation(Grille& Fluide, const double X[3], Point_fluide& P){
+    int ijk[3];
+    bool interieur;
+    Fluide.in_cell(Point_3(X[0],X[1],X[2]),ijk[0],ijk[1],ijk[2],interieur);
+    const int N[3] = {Nx, Ny, Nz};
+    if(!interieur || ijk[0]<marge || ijk[0]>=Nx+marge || ijk[1]<marge || ijk[1]>=Ny+marge || ijk[2]<marge || ijk[2]>=Nz+marge){
+      return false;
+    }
+    const Cellule& C = Fluide.grille[ijk[0]][ijk[1]][ijk[2]];
+    const double centre[3] = {C.x, C.y, C.z};
+    const double pas_grille[3] = {C.dx, C.dy, C.dz};
+    int bas[3];
+    double f[3];
+    for(int a=0; a<3; a++){
+      const double decalage = (X[a]-centre[a])/pas_grille[a];
+      bas[a] = (decalage<0.) ? ijk[a]-1 : ijk[a];
+      f[a] = (decalage<0.) ? 1.+decalage : decalage;
+      if(bas[a]+1>N[a]+2*marge-1){
+	bas[a] = N[a]+2*marge-2;
+	f[a] = 1.;
+      }
+    }
+    for(int c=0; c<8; c++){
+      const int di = c&1, dj = (c>>1)&1, dk = (c>>2)&1;
+      P.i[c] = bas[0]+di;
+      P.j[c] = bas[1]+dj;
+      P.k[c] = bas[2]+dk;
+      P.poids[c] = (di ? f[0] : 1.-f[0])*(dj ? f[1] : 1.-f[1])*(dk ? f[2] : 1.-f[2]);
+    }
+    return true;
+  }
+
+  std::vector<Point_fluide> points; //!< Fluid probes
+  std::vector<int> particules;      //!< Indices of the particles with a sensor
+  int pas;                          //!< Stride in time iterations of the sampling
+  int nb_colonnes;                  //!< Number of values per sample (time included), 0 without probe
+  std::vector<double> tampon;       //!< Samples not written yet, \a nb_colonnes per row
+  int nb_lignes;                    //!< Number of samples in \a tampon
+  std::ofstream fichier;            //!< File resultats/sondes.bin
+};
+
+#endif
@@ -0,0 +1,499 @@
+//Copyright 2017 Laurent Monasse
+
+/*
+  This file is part of CELIA3D.
+
+  CELIA3D is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  CELIA3D is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with CELIA3D.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+   \file
+   \authors Laurent Monasse and Maria Adela Puscas
+   \brief Outputs in a single HDF5 file resultats/resultats.h5, described for Paraview by resultats/resultats.xmf (XDMF).
+   \details Compiled only with -DCELIA3D_HDF5 (link with the HDF5 C library). Layout of the file, indexed by the index n of the output:
+   - /temps: time of each output;
+   - /fluide/<n>/pressure, density, u, v, w, alpha: 3-D chunked datasets on the cells without the margins, of dimensions (Nz,Ny,Nx) (x-index fastest);
+   - /solide/triangles, /solide/particule: connectivity of the triangles and index of their particle, written once;
+   - /solide/sommets: extendible dataset (n, vertex, coordinate) of the vertices of the triangles (3 per triangle);
+   - /solide/centres, Dx, u, e, omega: extendible datasets (n, particle, component) of the centers and of the kinematics of the particles.
+   On a restart, the file is opened again if it exists: the outputs written by the interrupted run after the checkpoint are removed (rows of the extendible datasets, fluid groups), the descriptor is written again from the remaining outputs, and the file is then completed. Otherwise it is created again.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include "parametres.hpp"
+#include "fluide.hpp"
+#include "solide.hpp"
+#include "journal.hpp"
+#ifdef CELIA3D_HDF5
+#include <hdf5.h>
+#endif
+
+#ifndef SORTIE_HDF5_HPP
+#define SORTIE_HDF5_HPP
+
+#ifdef CELIA3D_HDF5
+
+const H5Z_filter_t filtre_lz4 = 32004; //!< Identifier of the LZ4 filter registered for HDF5
+
+/*!\brief Writing of the outputs in resultats/resultats.h5 and of the XDMF descriptor resultats/resultats.xmf.
+  \details The file stays open between the outputs and is closed by the destructor. The XDMF descriptor is written again after each output, so that Paraview can open the results during the computation. The failures of the HDF5 calls are reported with \a Journal.Erreur.
+*/
+class Sortie_hdf5
+{
+public:
+  static const bool disponible = true; //!< The HDF5 outputs are compiled
+
+  /*!\brief Constructor: nothing is opened before the first output.
+    \param reprise true if the computation restarts: resultats.h5 is then completed instead of being created again
+    \param premiere_sortie index of the first output of the restarted computation: the outputs of the file from this index on are removed
+  */
+  Sortie_hdf5(const bool reprise, const int premiere_sortie): reprise(reprise), premiere_sortie(premiere_sortie), fichier(-1), dx(0.), dy(0.), dz(0.), nb_triangles(0), nb_particules(0) {}
+  ~Sortie_hdf5(){
+    if(fichier>=0){
+      Verifie(H5Fclose(fichier),"closing of","resultats.h5");
+    }
+  }
+
+  /*!\brief Appends the output \a n at time \a t of the fluid \a F and of the solid \a S.
+    \param F copy of the fluid fields
+    \param S copy of the solid data
+    \param t time of the output
+    \return void
+  */
+  void Ecrit(const Instantane_fluide& F, const Instantane_solide& S, const double t){
+    if(fichier<0 && !Ouvre()){
+      return;
+    }
+    const int n = F.n;
+    dx = F.dx; dy = F.dy; dz = F.dz;
+    const double temps[1] = {t};
+    const hsize_t ligne_temps[1] = {1};
+    if(!Ecrit_ligne("/temps",1,ligne_temps,H5T_NATIVE_DOUBLE,n,temps)){
+      return;
+    }
+
+    //Fluid: one group per output, fields transposed so that the x-index is the fastest
+    std::string groupe = Nom_groupe(n);
+    if(H5Lexists(fichier,groupe.c_str(),H5P_DEFAULT)>0){
+      Verifie(H5Ldelete(fichier,groupe.c_str(),H5P_DEFAULT),"deletion of",groupe);
+    }
+    hid_t g = H5Gcreate2(fichier,groupe.c_str(),H5P_DEFAULT,H5P_DEFAULT,H5P_DEFAULT);
+    if(!Verifie(g,"creation of",groupe)){
+      return;
+    }
+    const hsize_t dimensions[3] = {hsize_t(Nz), hsize_t(Ny), hsize_t(Nx)};
+    const hsize_t blocs[3] = {hsize_t(std::min(Nz,bloc_hdf5)), hsize_t(std::min(Ny,bloc_hdf5)), hsize_t(std::min(Nx,bloc_hdf5))};
+    hid_t espace = H5Screate_simple(3,dimensions,NULL);
+    hid_t proprietes = Proprietes(3,blocs,groupe);
+    std::vector<double> valeurs(Nx*Ny*Nz);
+    for(int m=0; m<6; m++){
+      const std::vector<double>& champ = F.champs[m];
+      for(int k=0; k<Nz; k++){
+	for(int j=0; j<Ny; j++){
+	  for(int i=0; i<Nx; i++){
+	    valeurs[i+Nx*(j+Ny*k)] = champ[k+Nz*(j+Ny*i)];
+	  }
+	}
+      }
+      const std::string nom = groupe+"/"+noms_fluide[m];
+      hid_t d = H5Dcreate2(g,noms_fluide[m],H5T_NATIVE_DOUBLE,espace,H5P_DEFAULT,proprietes,H5P_DEFAULT);
+      if(Verifie(d,"creation of",nom)){
+	Verifie(H5Dwrite(d,H5T_NATIVE_DOUBLE,H5S_ALL,H5S_ALL,H5P_DEFAULT,valeurs.data()),"writing of",nom);
+	H5Dclose(d);
+      }
+    }
+    H5Pclose(proprietes);
+    H5Sclose(espace);
+    H5Gclose(g);
+
+    //Solid: connectivity written once, then one row per output of the extendible datasets
+    const int nb_part = S.nb_triangles.size();
+    const int nb = S.sommets.size()/9;
+    if(H5Lexists(fichier,"/solide/triangles",H5P_DEFAULT)<=0){
+      Ecrit_connectivite(S);
+    }
+    if(nb!=nb_triangles){
+      std::ostringstream message;
+      message << "Output " << n << " in resultats.h5: " << nb << " triangles instead of " << nb_triangles << "\n";
+      journal.Erreur(message.str());
+      return;
+    }
+    const hsize_t ligne_sommets[2] = {hsize_t(3*nb), 3};
+    Ecrit_ligne("/solide/sommets",2,ligne_sommets,H5T_NATIVE_DOUBLE,n,S.sommets.data());
+    nb_particules = nb_part;
+    const hsize_t ligne_particules[2] = {hsize_t(nb_part), 3};
+    const std::vector<Vecteur_3>* cinematique[5] = {&S.centres, &S.Dx, &S.u, &S.e, &S.omega};
+    std::vector<double> composantes(3*nb_part);
+    for(int m=0; m<5; m++){
+      for(int it=0; it<nb_part; it++){
+	for(int c=0; c<3; c++){
+	  composantes[3*it+c] = (*cinematique[m])[it][c];
+	}
+      }
+      Ecrit_ligne(noms_particules[m],2,ligne_particules,H5T_NATIVE_DOUBLE,n,composantes.data());
+    }
+    Verifie(H5Fflush(fichier,H5F_SCOPE_GLOBAL),"flush of","resultats.h5");
+    Ecrit_xdmf();
+  }
+
+private:
+  /*!\brief Reports the failure of an HDF5 call with \a Journal.Erreur.
+    \param code value returned by the call (negative if it failed)
+    \param operation operation, followed by \a nom in the message
+    \param nom name of the file, group or dataset
+    \return bool: true if the call succeeded
+  */
+  static bool Verifie(const hid_t code, const char* operation, const std::string& nom){
+    if(code<0){
+      std::ostringstream message;
+      message << "resultats.h5: " << operation << " '" << nom << "' failed" << "\n";
+      journal.Erreur(message.str());
+      return false;
+    }
+    return true;
+  }
+
+  //! \brief Opens resultats/resultats.h5 on a restart and removes the outputs of the interrupted run from \a premiere_sortie on, or creates it with the groups /fluide and /solide
+  bool Ouvre(){
+    const char* nom = "resultats/resultats.h5";
+    std::ifstream existe(nom);
+    const bool complete = (reprise && existe && H5Fis_hdf5(nom)>0);
+    if(complete){
+      fichier = H5Fopen(nom,H5F_ACC_RDWR,H5P_DEFAULT);
+    } else {
+      fichier = H5Fcreate(nom,H5F_ACC_TRUNC,H5P_DEFAULT,H5P_DEFAULT);
+    }
+    if(!Verifie(fichier,complete ? "opening of" : "creation of",nom)){
+      return false;
+    }
+    const char* groupes[2] = {"/fluide", "/solide"};
+    for(int m=0; m<2; m++){
+      if(H5Lexists(fichier,groupes[m],H5P_DEFAULT)<=0){
+	hid_t g = H5Gcreate2(fichier,groupes[m],H5P_DEFAULT,H5P_DEFAULT,H5P_DEFAULT);
+	if(!Verifie(g,"creation of",groupes[m])){
+	  return false;
+	}
+	H5Gclose(g);
+      }
+    }
+    hsize_t dimensions[3];
+    if(Dimensions("/solide/particule",dimensions)){
+      nb_triangles = dimensions[0];
+    }
+    if(Dimensions("/solide/Dx",dimensions)){
+      nb_particules = dimensions[1];
+    }
+    if(complete){
+      Tronque();
+      if(H5Lexists(fichier,"/temps",H5P_DEFAULT)>0){
+	Ecrit_xdmf();
+      }
+    }
+    return true;
+  }
+
+  //! \brief Reads in \a dimensions the dimensions of the dataset \a nom; returns false if it does not exist or cannot be read
+  bool Dimensions(const char* nom, hsize_t* dimensions){
+    if(H5Lexists(fichier,nom,H5P_DEFAULT)<=0){
+      return false;
+    }
+    hid_t d = H5Dopen2(fichier,nom,H5P_DEFAULT);
+    if(!Verifie(d,"opening of",nom)){
+      return false;
+    }
+    hid_t espace = H5Dget_space(d);
+    const int rang = H5Sget_simple_extent_dims(espace,dimensions,NULL);
+    H5Sclose(espace);
+    H5Dclose(d);
+    return Verifie(rang,"reading of the dimensions of",nom);
+  }
+
+  /*!\brief Removes the outputs of index \a premiere_sortie and more written by the interrupted run.
+    \details The extendible datasets (/temps, /solide/sommets and the kinematics of the particles) are shrunk to \a premiere_sortie rows and the fluid groups of larger index are deleted, so that the file holds the outputs up to the checkpoint only.
+  */
+  void Tronque(){
+    const hsize_t n = premiere_sortie;
+    for(int m=-2; m<5; m++){
+      const char* nom = (m==-2) ? "/temps" : (m==-1) ? "/solide/sommets" : noms_particules[m];
+      hsize_t dimensions[3];
+      if(!Dimensions(nom,dimensions) || dimensions[0]<=n){
+	continue;
+      }
+      dimensions[0] = n;
+      hid_t d = H5Dopen2(fichier,nom,H5P_DEFAULT);
+      if(Verifie(d,"opening of",nom)){
+	Verifie(H5Dset_extent(d,dimensions),"truncation of",nom);
+	H5Dclose(d);
+      }
+    }
+    //Fluid groups: the names are read before the deletions, which change the indices of the links
+    hid_t g = H5Gopen2(fichier,"/fluide",H5P_DEFAULT);
+    if(!Verifie(g,"opening of","/fluide")){
+      return;
+    }
+    H5G_info_t infos;
+    std::vector<std::string> groupes;
+    if(Verifie(H5Gget_info(g,&infos),"reading of the links of","/fluide")){
+      for(hsize_t l=0; l<infos.nlinks; l++){
+	char nom[32];
+	const ssize_t taille = H5Lget_name_by_idx(g,".",H5_INDEX_NAME,H5_ITER_INC,l,nom,sizeof(nom),H5P_DEFAULT);
+	if(Verifie(taille,"reading of a link of","/fluide") && atoi(nom)>=premiere_sortie){
+	  groupes.push_back(nom);
+	}
+      }
+    }
+    for(int l=0; l<groupes.size(); l++){
+      Verifie(H5Ldelete(g,groupes[l].c_str(),H5P_DEFAULT),"deletion of","/fluide/"+groupes[l]);
+    }
+    H5Gclose(g);
+  }
+
+  //! \brief Name of the group of the fluid output \a n
+  static std::string Nom_groupe(const int n){
+    std::ostringstream nom;
+    nom << "/fluide/" << std::setw(6) << std::setfill('0') << n;
+    return nom.str();
+  }
+
+  //! \brief Creation properties of the dataset(s) \a nom of rank \a rang: chunks of size \a blocs and compression filter \a compression_hdf5
+  static hid_t Proprietes(const int rang, const hsize_t* blocs, const std::string& nom){
+    hid_t proprietes = H5Pcreate(H5P_DATASET_CREATE);
+    Verifie(H5Pset_chunk(proprietes,rang,blocs),"chunks of",nom);
+    if(compression_hdf5==hdf5_lz4 && H5Zfilter_avail(filtre_lz4)>0){
+      Verifie(H5Pset_filter(proprietes,filtre_lz4,H5Z_FLAG_OPTIONAL,0,NULL),"LZ4 filter of",nom);
+    }
+    else if(compression_hdf5!=hdf5_sans_compression){
+      Verifie(H5Pset_shuffle(proprietes),"shuffle filter of",nom);
+      Verifie(H5Pset_deflate(proprietes,niveau_gzip),"gzip filter of",nom);
+    }
+    return proprietes;
+  }
+
+  /*!\brief Writes the row \a n of the extendible dataset \a nom, created if needed.
+    \param nom name of the dataset
+    \param rang rank of a row
+    \param ligne dimensions of a row
+    \param type type of the values
+    \param n index of the row (index of the output)
+    \param valeurs values of the row
+    \return bool: true if the row has been written
+  */
+  bool Ecrit_ligne(const char* nom, const int rang, const hsize_t* ligne, const hid_t type, const int n, const void* valeurs){
+    std::vector<hsize_t> dimensions(rang+1), maximum(rang+1), debut(rang+1,0), nombre(rang+1);
+    dimensions[0] = 0; maximum[0] = H5S_UNLIMITED; nombre[0] = 1;
+    for(int r=0; r<rang; r++){
+      dimensions[r+1] = maximum[r+1] = nombre[r+1] = ligne[r];
+    }
+    hid_t d;
+    if(H5Lexists(fichier,nom,H5P_DEFAULT)>0){
+      d = H5Dopen2(fichier,nom,H5P_DEFAULT);
+      if(!Verifie(d,"opening of",nom)){
+	return false;
+      }
+      hid_t espace = H5Dget_space(d);
+      H5Sget_simple_extent_dims(espace,dimensions.data(),NULL);
+      H5Sclose(espace);
+    } else {
+      hid_t espace = H5Screate_simple(rang+1,dimensions.data(),maximum.data());
+      hid_t proprietes = Proprietes(rang+1,nombre.data(),nom);
+      d = H5Dcreate2(fichier,nom,type,espace,H5P_DEFAULT,proprietes,H5P_DEFAULT);
+      H5Pclose(proprietes);
+      H5Sclose(espace);
+      if(!Verifie(d,"creation of",nom)){
+	return false;
+      }
+    }
+    bool ecrit = true;
+    if(dimensions[0]<=hsize_t(n)){
+      dimensions[0] = n+1;
+      ecrit = Verifie(H5Dset_extent(d,dimensions.data()),"extension of",nom);
+    }
+    if(ecrit){
+      debut[0] = n;
+      hid_t espace = H5Dget_space(d);
+      hid_t memoire = H5Screate_simple(rang+1,nombre.data(),NULL);
+      ecrit = Verifie(H5Sselect_hyperslab(espace,H5S_SELECT_SET,debut.data(),NULL,nombre.data(),NULL),"selection of a row of",nom)
+	&& Verifie(H5Dwrite(d,type,memoire,espace,H5P_DEFAULT,valeurs),"writing of",nom);
+      H5Sclose(memoire);
+      H5Sclose(espace);
+    }
+    H5Dclose(d);
+    return ecrit;
+  }
+
+  //! \brief Writes the connectivity of the triangles (/solide/triangles) and the index of their particle (/solide/particule)
+  void Ecrit_connectivite(const Instantane_solide& S){
+    nb_triangles = S.sommets.size()/9;
+    std::vector<int> triangles(3*nb_triangles), particules(nb_triangles);
+    for(int l=0; l<3*nb_triangles; l++){
+      triangles[l] = l;
+    }
+    for(int it=0, l=0; it<S.nb_triangles.size(); it++){
+      for(int m=0; m<S.nb_triangles[it]; m++){
+	particules[l++] = it;
+      }
+    }
+    const hsize_t dimensions[2] = {hsize_t(nb_triangles), 3};
+    const char* noms[2] = {"/solide/triangles", "/solide/particule"};
+    const int* valeurs[2] = {triangles.data(), particules.data()};
+    for(int m=0; m<2; m++){
+      hid_t espace = H5Screate_simple(2-m,dimensions,NULL);
+      hid_t d = H5Dcreate2(fichier,noms[m],H5T_NATIVE_INT,espace,H5P_DEFAULT,H5P_DEFAULT,H5P_DEFAULT);
+      if(Verifie(d,"creation of",noms[m])){
+	Verifie(H5Dwrite(d,H5T_NATIVE_INT,H5S_ALL,H5S_ALL,H5P_DEFAULT,valeurs[m]),"writing of",noms[m]);
+	H5Dclose(d);
+      }
+      H5Sclose(espace);
+    }
+  }
+
+  /*!\brief Writes the XDMF descriptor resultats/resultats.xmf of all the outputs of the file.
+    \details Three temporal collections: the fluid on the uniform grid (3DCoRectMesh), the solid as triangles whose vertices are the row n of /solide/sommets, and the particles as points at their centers carrying their kinematics (Dx, u, e, omega). The descriptor is written under a temporary name then renamed, so that Paraview never reads a truncated file.
+  */
+  void Ecrit_xdmf(){
+    //Times of the outputs
+    hsize_t nb_sorties;
+    if(!Dimensions("/temps",&nb_sorties)){
+      return;
+    }
+    std::vector<double> temps(nb_sorties);
+    hid_t d = H5Dopen2(fichier,"/temps",H5P_DEFAULT);
+    if(!Verifie(d,"opening of","/temps")){
+      return;
+    }
+    const herr_t lu = (nb_sorties>0) ? H5Dread(d,H5T_NATIVE_DOUBLE,H5S_ALL,H5S_ALL,H5P_DEFAULT,temps.data()) : 0;
+    H5Dclose(d);
+    if(!Verifie(lu,"reading of","/temps")){
+      return;
+    }
+    //Fluid outputs present in the file
+    std::vector<bool> fluide(nb_sorties);
+    for(int n=0; n<nb_sorties; n++){
+      fluide[n] = (H5Lexists(fichier,Nom_groupe(n).c_str(),H5P_DEFAULT)>0);
+    }
+
+    const char* nom = "resultats/resultats.xmf";
+    const std::string nom_tmp = std::string(nom)+".tmp";
+    std::ofstream xmf(nom_tmp.c_str(),std::ios::out);
+    if(!xmf){
+      journal.Erreur("Opening of 'resultats.xmf' failed\n");
+      return;
+    }
+    xmf << std::setprecision(15);
+    xmf << "<?xml version=\"1.0\" ?>" << "\n";
+    xmf << "<!DOCTYPE Xdmf SYSTEM \"Xdmf.dtd\" []>" << "\n";
+    xmf << "<Xdmf Version=\"2.0\">" << "\n";
+    xmf << " <Domain>" << "\n";
+    xmf << "  <Grid Name=\"fluide\" GridType=\"Collection\" CollectionType=\"Temporal\">" << "\n";
+    for(int n=0; n<nb_sorties; n++){
+      if(!fluide[n]){
+	continue;
+      }
+      const std::string groupe = Nom_groupe(n);
+      xmf << "   <Grid Name=\"fluide" << n << "\" GridType=\"Uniform\">" << "\n";
+      xmf << "    <Time Value=\"" << temps[n] << "\"/>" << "\n";
+      xmf << "    <Topology TopologyType=\"3DCoRectMesh\" Dimensions=\"" << Nz+1 << " " << Ny+1 << " " << Nx+1 << "\"/>" << "\n";
+      xmf << "    <Geometry GeometryType=\"ORIGIN_DXDYDZ\">" << "\n";
+      xmf << "     <DataItem Dimensions=\"3\" Format=\"XML\">0 0 0</DataItem>" << "\n";
+      xmf << "     <DataItem Dimensions=\"3\" Format=\"XML\">" << dz << " " << dy << " " << dx << "</DataItem>" << "\n";
+      xmf << "    </Geometry>" << "\n";
+      for(int m=0; m<6; m++){
+	xmf << "    <Attribute Name=\"" << noms_fluide[m] << "\" AttributeType=\"Scalar\" Center=\"Cell\">" << "\n";
+	xmf << "     <DataItem Dimensions=\"" << Nz << " " << Ny << " " << Nx << "\" NumberType=\"Float\" Precision=\"8\" Format=\"HDF\">resultats.h5:" << groupe << "/" << noms_fluide[m] << "</DataItem>" << "\n";
+	xmf << "    </Attribute>" << "\n";
+      }
+      xmf << "   </Grid>" << "\n";
+    }
+    xmf << "  </Grid>" << "\n";
+    xmf << "  <Grid Name=\"solide\" GridType=\"Collection\" CollectionType=\"Temporal\">" << "\n";
+    for(int n=0; n<nb_sorties && nb_triangles>0; n++){
+      xmf << "   <Grid Name=\"solide" << n << "\" GridType=\"Uniform\">" << "\n";
+      xmf << "    <Time Value=\"" << temps[n] << "\"/>" << "\n";
+      xmf << "    <Topology TopologyType=\"Triangle\" NumberOfElements=\"" << nb_triangles << "\">" << "\n";
+      xmf << "     <DataItem Dimensions=\"" << nb_triangles << " 3\" NumberType=\"Int\" Format=\"HDF\">resultats.h5:/solide/triangles</DataItem>" << "\n";
+      xmf << "    </Topology>" << "\n";
+      xmf << "    <Geometry GeometryType=\"XYZ\">" << "\n";
+      xmf << "     <DataItem ItemType=\"HyperSlab\" Dimensions=\"" << 3*nb_triangles << " 3\" Type=\"HyperSlab\">" << "\n";
+      xmf << "      <DataItem Dimensions=\"3 3\" Format=\"XML\">" << n << " 0 0 1 1 1 1 " << 3*nb_triangles << " 3</DataItem>" << "\n";
+      xmf << "      <DataItem Dimensions=\"" << nb_sorties << " " << 3*nb_triangles << " 3\" NumberType=\"Float\" Precision=\"8\" Format=\"HDF\">resultats.h5:/solide/sommets</DataItem>" << "\n";
+      xmf << "     </DataItem>" << "\n";
+      xmf << "    </Geometry>" << "\n";
+      xmf << "    <Attribute Name=\"particule\" AttributeType=\"Scalar\" Center=\"Cell\">" << "\n";
+      xmf << "     <DataItem Dimensions=\"" << nb_triangles << "\" NumberType=\"Int\" Format=\"HDF\">resultats.h5:/solide/particule</DataItem>" << "\n";
+      xmf << "    </Attribute>" << "\n";
+      xmf << "   </Grid>" << "\n";
+    }
+    xmf << "  </Grid>" << "\n";
+    xmf << "  <Grid Name=\"particules\" GridType=\"Collection\" CollectionType=\"Temporal\">" << "\n";
+    const char* noms_cinematique[5] = {"centres", "Dx", "u", "e", "omega"};
+    for(int n=0; n<nb_sorties && nb_particules>0; n++){
+      xmf << "   <Grid Name=\"particules" << n << "\" GridType=\"Uniform\">" << "\n";
+      xmf << "    <Time Value=\"" << temps[n] << "\"/>" << "\n";
+      xmf << "    <Topology TopologyType=\"Polyvertex\" NumberOfElements=\"" << nb_particules << "\" NodesPerElement=\"1\"/>" << "\n";
+      for(int m=0; m<5; m++){
+	if(m==0){
+	  xmf << "    <Geometry GeometryType=\"XYZ\">" << "\n";
+	} else {
+	  xmf << "    <Attribute Name=\"" << noms_cinematique[m] << "\" AttributeType=\"Vector\" Center=\"Node\">" << "\n";
+	}
+	xmf << "     <DataItem ItemType=\"HyperSlab\" Dimensions=\"" << nb_particules << " 3\" Type=\"HyperSlab\">" << "\n";
+	xmf << "      <DataItem Dimensions=\"3 3\" Format=\"XML\">" << n << " 0 0 1 1 1 1 " << nb_particules << " 3</DataItem>" << "\n";
+	xmf << "      <DataItem Dimensions=\"" << nb_sorties << " " << nb_particules << " 3\" NumberType=\"Float\" Precision=\"8\" Format=\"HDF\">resultats.h5:/solide/" << noms_cinematique[m] << "</DataItem>" << "\n";
+	xmf << "     </DataItem>" << "\n";
+	xmf << ((m==0) ? "    </Geometry>" : "    </Attribute>") << "\n";
+      }
+      xmf << "   </Grid>" << "\n";
+    }
+    xmf << "  </Grid>" << "\n";
+    xmf << " </Domain>" << "\n";
+    xmf << "</Xdmf>" << "\n";
+    xmf.close();
+    if(!xmf || std::rename(nom_tmp.c_str(),nom)!=0){
+      journal.Erreur("Writing of 'resultats.xmf' failed\n");
+    }
+  }
+
+  static const char* const noms_fluide[6];     //!< Names of the fluid datasets
+  static const char* const noms_particules[5]; //!< Names of the datasets of the centers and of the kinematics of the particles
+  bool reprise;        //!< Restart: the existing file is completed
+  int premiere_sortie; //!< Index of the first output of the restarted computation
+  hid_t fichier;       //!< HDF5 file (negative if not open)
+  double dx, dy, dz;   //!< Spatial discretization steps of the last output
+  int nb_triangles;    //!< Number of triangles of the solid
+  int nb_particules;   //!< Number of particles of the solid
+};
+
+const char* const Sortie_hdf5::noms_fluide[6] = {"pressure", "density", "u", "v", "w", "alpha"};
+const char* const Sortie_hdf5::noms_particules[5] = {"/solide/centres", "/solide/Dx", "/solide/u", "/solide/e", "/solide/omega"};
+
+#else
+
+//! \brief Without -DCELIA3D_HDF5, the HDF5 outputs are not available and the vtk files are written.
+class Sortie_hdf5
+{
+public:
+  static const bool disponible = false; //!< The HDF5 outputs are not compiled
+  Sortie_hdf5(const bool, const int){}
+  void Ecrit(const Instantane_fluide&, const Instantane_solide&, const double){}
+};
+
+#endif
+
+#endif
@@ -0,0 +1,103 @@
+//Copyright 2017 Laurent Monasse
+
+/*
+  This file is part of CELIA3D.
+  
+  CELIA3D is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  CELIA3D is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  
+  You should have received a copy of the GNU General Public License
+  along with CELIA3D.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+   \file
+   \authors Laurent Monasse and Maria Adela Puscas
+   \brief Writing and reading of arrays in the vtk files, in ASCII or in binary (legacy vtk format, big-endian).
+ */
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+
+#ifndef SORTIES_HPP
+#define SORTIES_HPP
+
+//! \brief True if the machine stores numbers in big-endian order
+inline bool gros_boutiste(){
+  const int un = 1;
+  return *reinterpret_cast<const char*>(&un) == 0;
+}
+
+//! \brief Reverses the order of the bytes of the \a n values of size \a taille stored in \a octets
+inline void Inverse_octets(char* octets, const size_t n, const size_t taille){
+  for(size_t l=0;l<n;l++){
+    std::reverse(octets+l*taille, octets+(l+1)*taille);
+  }
+}
+
+/*!\brief Writes the array \a data in the vtk file \a vtk, followed by an end of line.
+   \details In binary, the values are written in big-endian order by blocks of 65536 values. In ASCII, \a nl values are written per line.
+   \param vtk output flux (opened in binary mode)
+   \param data array
+   \param nl number of values per line in ASCII
+   \param binaire binary (true) or ASCII (false) output
+   \return void
+*/
+template<class T>
+void Ecrit_tableau_vtk(std::ostream& vtk, const std::vector<T>& data, const int nl, const bool binaire){
+  const size_t n = data.size();
+  if(binaire && n>0){
+    if(gros_boutiste()){
+      vtk.write(reinterpret_cast<const char*>(&data[0]), n*sizeof(T));
+    }
+    else{
+      const size_t bloc = 65536;
+      std::vector<T> tampon(std::min(n,bloc));
+      for(size_t debut=0; debut<n; debut+=bloc){
+	const size_t taille = std::min(bloc,n-debut);
+	std::copy(data.begin()+debut, data.begin()+debut+taille, tampon.begin());
+	Inverse_octets(reinterpret_cast<char*>(&tampon[0]), taille, sizeof(T));
+	vtk.write(reinterpret_cast<const char*>(&tampon[0]), taille*sizeof(T));
+      }
+    }
+  }
+  else if(!binaire){
+    for(size_t l=0;l<n;l++){
+      vtk << data[l] << (((l+1)%nl==0) ? "\n" : " ");
+    }
+  }
+  vtk << "\n";
+}
+
+/*!\brief Reads the array \a data written by \a Ecrit_tableau_vtk.
+   \param in input flux (opened in binary mode)
+   \param data array, of the size of the array to read
+   \param binaire binary (true) or ASCII (false) input
+   \return void
+*/
+template<class T>
+void Lit_tableau_vtk(std::istream& in, std::vector<T>& data, const bool binaire){
+  const size_t n = data.size();
+  if(binaire && n>0){
+    in.read(reinterpret_cast<char*>(&data[0]), n*sizeof(T));
+    if(!gros_boutiste()){
+      Inverse_octets(reinterpret_cast<char*>(&data[0]), n, sizeof(T));
+    }
+  }
+  else if(!binaire){
+    for(size_t l=0;l<n;l++){
+      in >> data[l];
+    }
+  }
+}
+
+#endif